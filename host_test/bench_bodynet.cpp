@@ -0,0 +1,249 @@
+// 多节点组网仿真: 回环传输上的汇聚端 + N-1 个远端节点, 各节点时钟注入偏移和漂移, 每个包注入随机传输延迟;
+// 样本按400Hz采集、按主循环周期成批处理; 用样本里编码的真实时间测量对齐后的同步误差
+//   bench_bodynet [主循环周期ms [采样周期us]]
+#include "bodynet/bodynet.h"
+#include "test_util.h"
+#include <stdlib.h>
+
+#define SIM_NODES 4
+#define SIM_DURATION_US 20000000 // 20秒
+#define SIM_WARMUP_US 2000000    // 前2秒对时收敛, 不计入统计
+#define SIM_FRAME_PERIOD_US 50000
+#define SIM_SIGNAL_ZERO_MS 10000.0f // 真实时间编码为 (t_ms - 10000), 保持float精度约1us
+#define SIM_LATENCY_MIN_US 200      // 单程传输延迟范围 (ESP-NOW 约0.5ms)
+#define SIM_LATENCY_MAX_US 800
+
+// 远端节点时钟: node = true + offset + drift * true
+static const int64_t node_offset_us[SIM_NODES] = {0, 1234567, -8765432, 42000000};
+static const double node_drift[SIM_NODES] = {0, 40e-6, -25e-6, 60e-6};
+
+static int64_t sim_true_us = 0;
+static uint32_t latency_seed = 1;
+
+typedef struct
+{
+    double abs_sum_us;
+    double max_us;
+    int count;
+} sync_error_t;
+
+typedef struct
+{
+    int frames;
+    int full_frames;
+    sync_error_t error[SIM_NODES];
+    double clock_error_us[SIM_NODES]; // 结束时时钟换算的误差
+    double merge_ns;
+    uint32_t dropped;
+    uint32_t send_failures; // 汇聚端和各节点的发送失败总数
+} sim_result_t;
+
+static bodynet_loopback_bus_t bus;
+static bodynet_loopback_port_t ports[SIM_NODES];
+static bodynet_hub_t hub;
+static bodynet_node_t nodes[SIM_NODES];
+
+static int64_t node_time(int id, int64_t true_us)
+{
+    return true_us + node_offset_us[id] + (int64_t)(node_drift[id] * (double)true_us);
+}
+
+// 包到达接收方的本地时间: 当前真实时间加随机传输延迟
+static int64_t arrival_clock(uint8_t node_id)
+{
+    latency_seed = latency_seed * 1664525u + 1013904223u;
+    int64_t latency = SIM_LATENCY_MIN_US + (latency_seed >> 8) % (SIM_LATENCY_MAX_US - SIM_LATENCY_MIN_US);
+    return node_time(node_id, sim_true_us + latency);
+}
+
+// 样本携带采样时的真实时间
+static imu_data_t sample_at(int64_t true_us)
+{
+    imu_data_t d = {};
+    d.accel_x = (float)((double)true_us / 1000.0 - SIM_SIGNAL_ZERO_MS);
+    d.accel_z = 1.0f;
+    return d;
+}
+
+static sim_result_t simulate(uint32_t loop_us, uint32_t sample_us)
+{
+    sim_result_t result = {};
+
+    bodynet_loopback_init(&bus, arrival_clock);
+    bodynet_transport_t hub_transport = bodynet_loopback_transport(&ports[0], &bus, 0);
+    bodynet_hub_init(&hub, 0, (1 << SIM_NODES) - 1, SIM_FRAME_PERIOD_US, &hub_transport);
+    for (int id = 1; id < SIM_NODES; id++)
+    {
+        bodynet_transport_t transport = bodynet_loopback_transport(&ports[id], &bus, id);
+        bodynet_node_init(&nodes[id], id, 0, &transport);
+    }
+
+    // 各节点主循环相位错开 (至少相隔1ms, 大于传输延迟), 每次循环处理上次以来的全部样本 (与设备上 imu_read_samples 一致)
+    int64_t next_loop[SIM_NODES];
+    int64_t next_sample[SIM_NODES];
+    for (int id = 0; id < SIM_NODES; id++)
+    {
+        next_loop[id] = (int64_t)id * 7000 % loop_us + loop_us;
+        next_sample[id] = 0;
+    }
+
+    uint32_t dropped_at_warmup = 0;
+    for (int64_t t = 0; t < SIM_DURATION_US; t += 500)
+    {
+        sim_true_us = t;
+        if (t == SIM_WARMUP_US)
+        {
+            dropped_at_warmup = hub.stats.samples_dropped;
+        }
+
+        for (int id = 0; id < SIM_NODES; id++)
+        {
+            if (t < next_loop[id])
+            {
+                continue;
+            }
+            next_loop[id] += loop_us;
+
+            for (; next_sample[id] <= t; next_sample[id] += sample_us)
+            {
+                imu_data_t d = sample_at(next_sample[id]);
+                if (id == 0)
+                {
+                    bodynet_hub_push_local(&hub, next_sample[id], &d);
+                }
+                else
+                {
+                    bodynet_node_push_sample(&nodes[id], node_time(id, next_sample[id]), &d);
+                }
+            }
+
+            if (id != 0)
+            {
+                bodynet_node_poll(&nodes[id], node_time(id, t));
+                continue;
+            }
+
+            bodynet_hub_poll(&hub, t);
+            bodynet_frame_t frame;
+            while (bodynet_hub_pop_frame(&hub, t, &frame))
+            {
+                if (t < SIM_WARMUP_US)
+                {
+                    continue;
+                }
+                result.frames++;
+                if (frame.valid_mask == (1 << SIM_NODES) - 1)
+                {
+                    result.full_frames++;
+                }
+                for (int i = 0; i < SIM_NODES; i++)
+                {
+                    if (!(frame.valid_mask & (1 << i)))
+                    {
+                        continue;
+                    }
+                    double expect_ms = (double)frame.t_us / 1000.0 - SIM_SIGNAL_ZERO_MS;
+                    double err_us = fabs((frame.limbs[i].accel_x - expect_ms) * 1000.0);
+                    sync_error_t *e = &result.error[i];
+                    e->abs_sum_us += err_us;
+                    e->max_us = err_us > e->max_us ? err_us : e->max_us;
+                    e->count++;
+                }
+            }
+        }
+    }
+
+    for (int id = 1; id < SIM_NODES; id++)
+    {
+        int64_t t = SIM_DURATION_US;
+        result.clock_error_us[id] = (double)(bodynet_clock_to_hub(&hub.peers[id].clock, node_time(id, t)) - t);
+    }
+    result.merge_ns = hub.stats.frames_out > 0 ? (double)hub.stats.merge_time_ns / hub.stats.frames_out : 0.0;
+    result.dropped = hub.stats.samples_dropped - dropped_at_warmup;
+    result.send_failures = hub.stats.send_failures;
+    for (int id = 1; id < SIM_NODES; id++)
+    {
+        result.send_failures += nodes[id].send_failures;
+    }
+    return result;
+}
+
+static void report(uint32_t loop_us, uint32_t sample_us, const sim_result_t *r)
+{
+    printf("主循环%ums 采样%.0fHz: 帧%d, 全部节点在线%.1f%%, 合并%.0fns/帧, 收敛后丢弃样本%lu\n", loop_us / 1000, 1e6 / sample_us, r->frames,
+           r->frames > 0 ? 100.0 * r->full_frames / r->frames : 0.0, r->merge_ns, (unsigned long)r->dropped);
+    for (int i = 0; i < SIM_NODES; i++)
+    {
+        const sync_error_t *e = &r->error[i];
+        printf("  节点%d: 偏移%+.3fs 漂移%+.0fppm -> 同步误差 平均%.0fus 最大%.0fus, 时钟换算误差%+.0fus\n", i,
+               node_offset_us[i] / 1e6, node_drift[i] * 1e6, e->count ? e->abs_sum_us / e->count : 0.0, e->max_us,
+               r->clock_error_us[i]);
+    }
+}
+
+// 对端不收包时邮箱写满, 传输层拒收的批和对时请求都要计入发送失败, 与邮箱丢弃数一致
+static void test_send_failures(void)
+{
+    bodynet_loopback_init(&bus, NULL);
+    bodynet_transport_t hub_transport = bodynet_loopback_transport(&ports[0], &bus, 0);
+    bodynet_transport_t node_transport = bodynet_loopback_transport(&ports[1], &bus, 1);
+    bodynet_hub_init(&hub, 0, 0x3, SIM_FRAME_PERIOD_US, &hub_transport);
+    bodynet_node_init(&nodes[1], 1, 0, &node_transport);
+
+    // 节点一直发送, 汇聚端不轮询
+    imu_data_t d = sample_at(0);
+    for (int i = 0; i < BODYNET_LOOPBACK_DEPTH + 5; i++)
+    {
+        bodynet_node_push_sample(&nodes[1], i, &d);
+        bodynet_node_flush(&nodes[1]);
+    }
+    CHECK(nodes[1].send_failures == 5);
+    CHECK(nodes[1].send_failures == bus.mailbox[0].dropped);
+
+    // 汇聚端周期对时, 节点不轮询; 汇聚端轮询会取走节点的批, 不影响节点邮箱
+    for (int i = 1; i <= BODYNET_LOOPBACK_DEPTH + 3; i++)
+    {
+        bodynet_hub_poll(&hub, (int64_t)i * hub.sync_period_us);
+    }
+    CHECK(hub.stats.send_failures == 3);
+    CHECK(hub.stats.send_failures == bus.mailbox[1].dropped);
+    printf("[发送失败] 节点%lu 汇聚端%lu\n", (unsigned long)nodes[1].send_failures, (unsigned long)hub.stats.send_failures);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc > 1)
+    {
+        uint32_t loop_us = (uint32_t)atoi(argv[1]) * 1000;
+        uint32_t sample_us = argc > 2 ? (uint32_t)atoi(argv[2]) : 2500;
+        sim_result_t r = simulate(loop_us, sample_us);
+        report(loop_us, sample_us, &r);
+        return 0;
+    }
+
+    test_send_failures();
+
+    // 400Hz 按10ms/50ms主循环成批处理; 20Hz 低速采样时未满的批靠等待时间发送, 节点不能超时
+    static const uint32_t cases[][2] = {{10000, 2500}, {50000, 2500}, {50000, 50000}};
+    for (const uint32_t *c : cases)
+    {
+        uint32_t loop_us = c[0], sample_us = c[1];
+        sim_result_t r = simulate(loop_us, sample_us);
+        report(loop_us, sample_us, &r);
+
+        CHECK(r.frames > 0);
+        CHECK(r.full_frames >= r.frames * 99 / 100);
+        CHECK(r.dropped == 0);
+        CHECK(r.send_failures == 0);
+        CHECK(r.error[0].max_us < 5.0); // 本地节点只有float量化误差
+        for (int i = 1; i < SIM_NODES; i++)
+        {
+            // 单次对时误差来自上下行延迟不对称, 最多为延迟范围的一半; 漂移外推会放大, 平均应远小于它
+            const sync_error_t *e = &r.error[i];
+            CHECK(e->count > 0 && e->abs_sum_us / e->count < (SIM_LATENCY_MAX_US - SIM_LATENCY_MIN_US) / 4);
+            CHECK(e->max_us < SIM_LATENCY_MAX_US - SIM_LATENCY_MIN_US);
+            CHECK(fabs(r.clock_error_us[i]) < (SIM_LATENCY_MAX_US - SIM_LATENCY_MIN_US) / 2);
+        }
+    }
+    return test_result("bench_bodynet");
+}
@@ -0,0 +1,126 @@
+// 滤波器组: 块处理与旧的逐样本标量低通、直接I型biquad参考实现输出一致, 并对比不同块长的耗时
+#include "filterbank/filterbank.h"
+#include "test_util.h"
+#include <string.h>
+
+static void test_set_alpha(void)
+{
+    filterbank_t bank;
+    filterbank_init(&bank);
+
+    // 一阶组上改alpha不改变一阶标记, 系数正确
+    filterbank_set_lowpass_alpha(&bank, FILTERBANK_ACCEL, 0.7f);
+    CHECK(bank.first_order);
+    CHECK_NEAR(bank.b0[FILTERBANK_ACCEL], 0.7f, 1e-6);
+    CHECK_NEAR(bank.a1[FILTERBANK_ACCEL], -0.3f, 1e-6);
+
+    // 有biquad通道时走完整路径, 改回一阶后重新判断
+    filterbank_set_biquad(&bank, FILTERBANK_GYRO, 0.2f, 0.4f, 0.2f, -0.5f, 0.3f);
+    CHECK(!bank.first_order);
+    filterbank_set_lowpass_alpha(&bank, FILTERBANK_GYRO, 0.9f);
+    CHECK(bank.first_order);
+    CHECK_NEAR(bank.b1[FILTERBANK_GYRO], 0.0f, 1e-6);
+}
+
+// 参考实现: 直接I型biquad, double 精度, 零初始状态
+typedef struct
+{
+    double b0, b1, b2, a1, a2;
+    double x1, x2, y1, y2;
+} ref_biquad_t;
+
+static double ref_biquad(ref_biquad_t *f, double x)
+{
+    double y = f->b0 * x + f->b1 * f->x1 + f->b2 * f->x2 - f->a1 * f->y1 - f->a2 * f->y2;
+    f->x2 = f->x1;
+    f->x1 = x;
+    f->y2 = f->y1;
+    f->y1 = y;
+    return y;
+}
+
+// 二阶路径的冲激响应和阶跃响应: 9个通道各用不同的系数, 按不同块长送入 (跨过 FILTERBANK_TILE 边界),
+// 逐样本与参考实现比较. 第一个样本为0, 使状态初始化为零状态
+static void test_biquad_response(void)
+{
+    static const float coeffs[FILTERBANK_CHANNELS][5] = {
+        {0.020083366f, 0.040166731f, 0.020083366f, -1.561018076f, 0.641351538f}, // 低通 fc=fs/20
+        {0.206572083f, 0.413144166f, 0.206572083f, -0.369527378f, 0.195815712f}, // 低通 fc=fs/5
+        {0.800592403f, -1.601184807f, 0.800592403f, -1.561018076f, 0.641351538f}, // 高通 fc=fs/20
+        {0.067455273f, 0.0f, -0.067455273f, -1.142980502f, 0.865089454f},        // 带通
+        {1.0f, -1.618033989f, 1.0f, -1.559552312f, 0.9409f},                     // 陷波
+        {0.5f, 0.0f, 0.0f, -0.5f, 0.0f},                                        // 一阶低通混在二阶组里
+        {1.0f, 0.0f, 0.0f, 0.0f, 0.0f},                                         // 直通
+        {0.1f, 0.2f, 0.1f, -1.8f, 0.98f},                                       // 高Q谐振
+        {0.25f, 0.5f, 0.25f, 0.0f, 0.0f},                                       // FIR
+    };
+    static const int block_lens[] = {1, 4, 5, 16, 37};
+    const int total = 200;
+    static imu_data_t in[200], out[200];
+
+    for (int step = 0; step < 2; step++)
+    {
+        for (int block_len : block_lens)
+        {
+            filterbank_t bank;
+            filterbank_init(&bank);
+            ref_biquad_t ref[FILTERBANK_CHANNELS] = {};
+            for (int c = 0; c < FILTERBANK_CHANNELS; c++)
+            {
+                const float *k = coeffs[c];
+                filterbank_set_biquad(&bank, c, k[0], k[1], k[2], k[3], k[4]);
+                ref[c] = {k[0], k[1], k[2], k[3], k[4], 0, 0, 0, 0};
+            }
+            CHECK(!bank.first_order);
+
+            for (int i = 0; i < total; i++)
+            {
+                float v = i == 0 ? 0.0f : (step || i == 1) ? 1.0f : 0.0f;
+                float *x = &in[i].accel_x;
+                for (int c = 0; c < FILTERBANK_CHANNELS; c++)
+                {
+                    x[c] = v;
+                }
+            }
+
+            memcpy(out, in, sizeof(in));
+            for (int start = 0; start < total; start += block_len)
+            {
+                int len = total - start < block_len ? total - start : block_len;
+                filterbank_process(&bank, &out[start], &out[start], len);
+            }
+
+            double max_err = 0.0;
+            for (int i = 0; i < total; i++)
+            {
+                const float *x = &in[i].accel_x;
+                const float *y = &out[i].accel_x;
+                for (int c = 0; c < FILTERBANK_CHANNELS; c++)
+                {
+                    double err = fabs(ref_biquad(&ref[c], x[c]) - y[c]);
+                    max_err = err > max_err ? err : max_err;
+                }
+            }
+            CHECK(max_err < 1e-4);
+            printf("biquad%s响应 块长%d: 最大误差 %.2e\n", step ? "阶跃" : "冲激", block_len, max_err);
+        }
+    }
+}
+
+int main()
+{
+    test_set_alpha();
+    test_biquad_response();
+
+    // 块长 1 即逐样本调用, 4 约为 400Hz FIFO 每次唤醒的帧数
+    static const int block_lens[] = {1, 4, 8, 32};
+    for (int biquad = 0; biquad < 2; biquad++)
+    {
+        for (int len : block_lens)
+        {
+            float diff = filterbank_benchmark(200000 / len, len, biquad);
+            CHECK(diff < 1e-4f);
+        }
+    }
+    return test_result("bench_filterbank");
+}
@@ -0,0 +1,168 @@
+// 滑动DFT: 5Hz测试音的主频/频带/功率与直接DFT比对, 低频晃动叠加抖动时的频带峰值, 并测量每样本更新和每个hop的耗时
+#include "spectral/spectral.h"
+#include "test_util.h"
+#include <chrono>
+
+#define RATE_HZ 50.0f
+#define HOP 8
+#define BENCH_SAMPLES 200000
+
+static volatile float bench_sink; // 防止计算被优化掉
+
+static imu_data_t tone_sample(int i, float hz, float amp)
+{
+    imu_data_t d = {};
+    float s = amp * sinf(2.0f * (float)M_PI * hz * i / RATE_HZ);
+    d.accel_x = s;
+    d.accel_y = 0.5f * s;
+    d.accel_z = 1.0f; // 重力, 直流不计入
+    d.gyro_z = 100.0f * s;
+    return d;
+}
+
+// 直接对最近 N 个样本做DFT, 求三轴加速度在频点 k 的合并功率 (与 compute_band 同一缩放)
+static float direct_power(const imu_data_t *window, int k)
+{
+    float p = 0.0f;
+    for (int c = 0; c < 3; c++)
+    {
+        float re = 0.0f, im = 0.0f;
+        for (int n = 0; n < SPECTRAL_N; n++)
+        {
+            float x = (&window[n].accel_x)[c];
+            float w = 2.0f * (float)M_PI * k * n / SPECTRAL_N;
+            re += x * cosf(w);
+            im -= x * sinf(w);
+        }
+        p += re * re + im * im;
+    }
+    return p * 4.0f / (SPECTRAL_N * SPECTRAL_N);
+}
+
+static void test_tone(void)
+{
+    static imu_data_t window[SPECTRAL_N];
+    spectral_features_t features = {};
+    bool got = false;
+
+    spectral_init(RATE_HZ, HOP);
+    int total = SPECTRAL_N * 4;
+    for (int i = 0; i < total; i++)
+    {
+        imu_data_t d = tone_sample(i, 5.0f, 0.1f);
+        window[(i - (total - SPECTRAL_N) + SPECTRAL_N) % SPECTRAL_N] = d;
+        got |= spectral_push(&d, &features);
+    }
+
+    CHECK(got);
+    CHECK_NEAR(features.accel.dominant_hz, 5.0f, 0.5f);
+    CHECK_NEAR(features.gyro.dominant_hz, 5.0f, 0.5f);
+
+    // 5Hz 落在 [4,8) Hz 频带
+    int best_band = 0;
+    for (int b = 1; b < SPECTRAL_NUM_BANDS; b++)
+    {
+        if (features.accel.band_energy[b] > features.accel.band_energy[best_band])
+        {
+            best_band = b;
+        }
+    }
+    CHECK(best_band == 2);
+
+    // 主频点功率与直接DFT一致 (阻尼系数 r^N 带来约1%偏差)
+    int k = (int)(5.0f * SPECTRAL_N / RATE_HZ + 0.5f);
+    float direct = fmaxf(direct_power(window, k - 1), fmaxf(direct_power(window, k), direct_power(window, k + 1)));
+    CHECK(fabsf(features.accel.dominant_power - direct) <= 0.03f * direct);
+
+    printf("5Hz测试音: 主频 %.2fHz (陀螺仪 %.2fHz), 频带%d, 功率 %.5f (直接DFT %.5f)\n",
+           features.accel.dominant_hz, features.gyro.dominant_hz, best_band,
+           features.accel.dominant_power, direct);
+}
+
+// 0.78Hz 的大幅身体晃动叠加 6Hz 抖动: 全局主频是晃动, [4,8) Hz 频带的峰值必须是抖动频率
+static void test_band_peak(void)
+{
+    spectral_features_t features = {};
+    bool got = false;
+
+    spectral_init(RATE_HZ, HOP);
+    for (int i = 0; i < SPECTRAL_N * 4; i++)
+    {
+        imu_data_t sway = tone_sample(i, 0.78125f, 0.3f);
+        imu_data_t shake = tone_sample(i, 6.0f, 0.05f);
+        imu_data_t d = sway;
+        d.accel_x += shake.accel_x;
+        d.accel_y += shake.accel_y;
+        got |= spectral_push(&d, &features);
+    }
+
+    CHECK(got);
+    CHECK(features.accel.dominant_hz < spectral_band_edges_hz[1]);
+    CHECK_NEAR(features.accel.band_peak_hz[2], 6.0f, 0.4f);
+    CHECK(features.accel.band_peak_hz[2] >= spectral_band_edges_hz[2] - 0.4f &&
+          features.accel.band_peak_hz[2] <= spectral_band_edges_hz[3] + 0.4f);
+
+    printf("晃动+抖动: 主频 %.2fHz, [4,8)Hz 频带峰值 %.2fHz\n",
+           features.accel.dominant_hz, features.accel.band_peak_hz[2]);
+}
+
+// 推入 n 个样本的耗时(纳秒)
+static double run_ns(int hop, int n, float *sink)
+{
+    spectral_features_t features = {};
+    spectral_init(RATE_HZ, hop);
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; i++)
+    {
+        imu_data_t d = tone_sample(i, 5.0f, 0.1f);
+        spectral_push(&d, &features);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    *sink += features.accel.dominant_hz;
+    return std::chrono::duration<double, std::nano>(t1 - t0).count();
+}
+
+static void bench(void)
+{
+    float sink = 0.0f;
+
+    // hop 极大时窗口填满后不再输出特征, 只剩每样本的滑动更新
+    double update_ns = run_ns(1 << 30, BENCH_SAMPLES, &sink) / BENCH_SAMPLES;
+    double total_ns = run_ns(HOP, BENCH_SAMPLES, &sink);
+    int hops = (BENCH_SAMPLES - SPECTRAL_N) / HOP;
+    double hop_ns = (total_ns - update_ns * BENCH_SAMPLES) / hops;
+
+    // 对比: 每个hop对整个窗口重新做DFT
+    static imu_data_t window[SPECTRAL_N];
+    for (int i = 0; i < SPECTRAL_N; i++)
+    {
+        window[i] = tone_sample(i, 5.0f, 0.1f);
+    }
+    int reps = 200;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; r++)
+    {
+        for (int k = 1; k <= SPECTRAL_BINS; k++)
+        {
+            sink += direct_power(window, k);
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    // direct_power 只算3个通道, 6通道按两倍计
+    double direct_hop_ns = 2.0 * std::chrono::duration<double, std::nano>(t1 - t0).count() / reps;
+
+    printf("滑动DFT耗时: 每样本更新 %.0fns, 每个hop特征 %.0fns, 每样本平均 %.0fns (hop=%d)\n",
+           update_ns, hop_ns, total_ns / BENCH_SAMPLES, HOP);
+    printf("对比每个hop直接DFT(逐项三角函数): %.0fns/hop, 每样本平均 %.0fns\n", direct_hop_ns, direct_hop_ns / HOP);
+    bench_sink = sink;
+}
+
+int main()
+{
+    test_tone();
+    test_band_peak();
+    bench();
+    return test_result("bench_spectral");
+}
@@ -0,0 +1,25 @@
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+// 主机测试用的 FreeRTOS 最小替身: 任务即线程, 队列和任务通知用 std::mutex/condition_variable 实现 (freertos_host.cpp)
+#include <stdint.h>
+#include <stddef.h>
+
+typedef struct host_task *TaskHandle_t;
+typedef struct host_queue *QueueHandle_t;
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+
+typedef struct
+{
+    int unused;
+} StaticQueue_t;
+
+#define pdTRUE 1
+#define pdFALSE 0
+#define pdPASS 1
+#define portMAX_DELAY 0xffffffffu
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+
+#endif // HOST_FREERTOS_H
\ No newline at end of file
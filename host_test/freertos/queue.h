@@ -0,0 +1,20 @@
+#ifndef HOST_FREERTOS_QUEUE_H
+#define HOST_FREERTOS_QUEUE_H
+
+#include "FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    // 存储区由调用者提供, 与目标板相同; 队列对象来自固定大小的池
+    QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t item_size, uint8_t *storage, StaticQueue_t *buf);
+    BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks);
+    BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_FREERTOS_QUEUE_H
\ No newline at end of file
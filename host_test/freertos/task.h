@@ -0,0 +1,20 @@
+#ifndef HOST_FREERTOS_TASK_H
+#define HOST_FREERTOS_TASK_H
+
+#include "FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    TaskHandle_t xTaskGetCurrentTaskHandle(void); // 每个线程一个句柄
+    BaseType_t xTaskNotifyGive(TaskHandle_t task);
+    uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks);
+    void vTaskDelay(TickType_t ticks);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HOST_FREERTOS_TASK_H
\ No newline at end of file
@@ -0,0 +1,127 @@
+// FreeRTOS 替身的实现, 只覆盖 imubus 用到的任务通知和队列
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string.h>
+#include <thread>
+
+#define HOST_QUEUE_MAX 4
+
+struct host_task
+{
+    std::mutex lock;
+    std::condition_variable cond;
+    uint32_t notify;
+};
+
+struct host_queue
+{
+    std::mutex lock;
+    std::condition_variable cond;
+    uint8_t *storage;
+    size_t length, item_size;
+    size_t head, count;
+};
+
+static host_queue queue_pool[HOST_QUEUE_MAX];
+static int queue_used = 0;
+
+static std::chrono::milliseconds ticks_to_ms(TickType_t ticks)
+{
+    return std::chrono::milliseconds(ticks);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    static thread_local host_task task;
+    return &task;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    std::lock_guard<std::mutex> guard(task->lock);
+    task->notify++;
+    task->cond.notify_one();
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks)
+{
+    host_task *task = xTaskGetCurrentTaskHandle();
+    std::unique_lock<std::mutex> guard(task->lock);
+    auto ready = [task] { return task->notify > 0; };
+    if (ticks == portMAX_DELAY)
+    {
+        task->cond.wait(guard, ready);
+    }
+    else if (!task->cond.wait_for(guard, ticks_to_ms(ticks), ready))
+    {
+        return 0;
+    }
+
+    uint32_t value = task->notify;
+    task->notify = clear_on_exit ? 0 : value - 1;
+    return value;
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    std::this_thread::sleep_for(ticks_to_ms(ticks));
+}
+
+QueueHandle_t xQueueCreateStatic(UBaseType_t length, UBaseType_t item_size, uint8_t *storage, StaticQueue_t *buf)
+{
+    if (queue_used >= HOST_QUEUE_MAX)
+    {
+        return NULL;
+    }
+    host_queue *q = &queue_pool[queue_used++];
+    q->storage = storage;
+    q->length = length;
+    q->item_size = item_size;
+    q->head = 0;
+    q->count = 0;
+    return q;
+}
+
+BaseType_t xQueueSend(QueueHandle_t q, const void *item, TickType_t ticks)
+{
+    std::unique_lock<std::mutex> guard(q->lock);
+    auto room = [q] { return q->count < q->length; };
+    if (ticks == portMAX_DELAY)
+    {
+        q->cond.wait(guard, room);
+    }
+    else if (!q->cond.wait_for(guard, ticks_to_ms(ticks), room))
+    {
+        return pdFALSE;
+    }
+
+    memcpy(&q->storage[((q->head + q->count) % q->length) * q->item_size], item, q->item_size);
+    q->count++;
+    q->cond.notify_all();
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t q, void *item, TickType_t ticks)
+{
+    std::unique_lock<std::mutex> guard(q->lock);
+    auto ready = [q] { return q->count > 0; };
+    if (ticks == portMAX_DELAY)
+    {
+        q->cond.wait(guard, ready);
+    }
+    else if (!q->cond.wait_for(guard, ticks_to_ms(ticks), ready))
+    {
+        return pdFALSE;
+    }
+
+    memcpy(item, &q->storage[q->head * q->item_size], q->item_size);
+    q->head = (q->head + 1) % q->length;
+    q->count--;
+    q->cond.notify_all();
+    return pdTRUE;
+}
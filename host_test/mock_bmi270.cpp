@@ -0,0 +1,145 @@
+#include "mock_bmi270.h"
+#include "imubus/bmi270_fifo.h"
+#include <string.h>
+
+void mock_bmi270_reset(mock_bmi270_t *dev)
+{
+    memset(dev, 0, sizeof(*dev));
+}
+
+void mock_bmi270_push(mock_bmi270_t *dev, const uint8_t *frame, size_t len)
+{
+    for (size_t i = 0; i < len; i++)
+    {
+        dev->fifo[(dev->head + dev->bytes + i) % MOCK_FIFO_BYTES] = frame[i];
+    }
+    dev->bytes += len;
+    dev->frame_len[(dev->frame_head + dev->frames) % MOCK_FIFO_FRAMES] = (uint16_t)len;
+    dev->frames++;
+}
+
+static void put_le16(uint8_t *p, int16_t v)
+{
+    p[0] = (uint8_t)(v & 0xFF);
+    p[1] = (uint8_t)((uint16_t)v >> 8);
+}
+
+void mock_bmi270_push_raw(mock_bmi270_t *dev, const int16_t gyr[3], const int16_t acc[3])
+{
+    uint8_t frame[BMI270_FIFO_FRAME_ACC_GYR];
+    frame[0] = 0x8C; // 数据帧, 陀螺仪 + 加速度
+    for (int i = 0; i < 3; i++)
+    {
+        put_le16(&frame[1 + i * 2], gyr[i]);
+        put_le16(&frame[7 + i * 2], acc[i]);
+    }
+    mock_bmi270_push(dev, frame, sizeof(frame));
+}
+
+void mock_bmi270_push_acc_gyr(mock_bmi270_t *dev, int16_t seq)
+{
+    int16_t gyr[3], acc[3];
+    for (int i = 0; i < 3; i++)
+    {
+        gyr[i] = (int16_t)(seq * 10 + i);
+        acc[i] = (int16_t)(seq * 100 + i);
+    }
+    mock_bmi270_push_raw(dev, gyr, acc);
+}
+
+void mock_bmi270_push_skip(mock_bmi270_t *dev, uint8_t count)
+{
+    uint8_t frame[2] = {BMI270_FIFO_HEADER_SKIP, count};
+    mock_bmi270_push(dev, frame, sizeof(frame));
+}
+
+static void read_fifo(mock_bmi270_t *dev, uint8_t *buf, size_t len)
+{
+    size_t out = 0;
+    while (dev->frames > 0 && out < len)
+    {
+        size_t frame = dev->frame_len[dev->frame_head];
+        size_t n = frame <= len - out ? frame : len - out;
+        for (size_t i = 0; i < n; i++)
+        {
+            buf[out + i] = dev->fifo[(dev->head + i) % MOCK_FIFO_BYTES];
+        }
+        out += n;
+        if (n < frame)
+        {
+            break; // 只读了一部分, 帧留在FIFO中
+        }
+        dev->head = (dev->head + frame) % MOCK_FIFO_BYTES;
+        dev->bytes -= frame;
+        dev->frame_head = (dev->frame_head + 1) % MOCK_FIFO_FRAMES;
+        dev->frames--;
+    }
+    if (out < len)
+    {
+        memset(&buf[out], BMI270_FIFO_HEADER_END, len - out);
+    }
+}
+
+static int mock_read(void *ctx, uint8_t dev_addr, uint8_t reg, uint8_t *buf, size_t len)
+{
+    mock_bmi270_t *dev = (mock_bmi270_t *)ctx;
+    if (dev_addr != BMI270_ADDR)
+    {
+        return -1;
+    }
+    if (dev->fail_reads > 0)
+    {
+        dev->fail_reads--;
+        return -1;
+    }
+
+    if (reg == BMI270_REG_FIFO_DATA)
+    {
+        dev->data_reads++;
+        dev->bytes_read += len;
+        read_fifo(dev, buf, len);
+    }
+    else if (reg == BMI270_REG_FIFO_LENGTH_0 && len == 2)
+    {
+        dev->length_reads++;
+        buf[0] = (uint8_t)(dev->bytes & 0xFF);
+        buf[1] = (uint8_t)((dev->bytes >> 8) & 0x3F);
+    }
+    else
+    {
+        for (size_t i = 0; i < len; i++)
+        {
+            buf[i] = dev->regs[(reg + i) & 0x7F];
+        }
+    }
+    return 0;
+}
+
+static int mock_write(void *ctx, uint8_t dev_addr, uint8_t reg, const uint8_t *buf, size_t len)
+{
+    mock_bmi270_t *dev = (mock_bmi270_t *)ctx;
+    if (dev_addr != BMI270_ADDR)
+    {
+        return -1;
+    }
+
+    for (size_t i = 0; i < len; i++)
+    {
+        dev->regs[(reg + i) & 0x7F] = buf[i];
+    }
+    if (reg == BMI270_REG_CMD && buf[0] == BMI270_CMD_FIFO_FLUSH)
+    {
+        dev->head = dev->bytes = 0;
+        dev->frame_head = dev->frames = 0;
+    }
+    return 0;
+}
+
+const imubus_ops_t *mock_bmi270_ops(mock_bmi270_t *dev)
+{
+    static imubus_ops_t ops;
+    ops.read = mock_read;
+    ops.write = mock_write;
+    ops.ctx = dev;
+    return &ops;
+}
@@ -0,0 +1,39 @@
+#ifndef MOCK_BMI270_H
+#define MOCK_BMI270_H
+
+// 模拟 BMI270 寄存器设备, 按数据手册的FIFO读取语义:
+//   - 按帧出队, 一次读取末尾只读到一部分的帧不出队, 下次读取重发整帧
+//   - FIFO读空后继续读返回 0x80
+//   - FIFO_LENGTH 返回当前字节数
+#include "imubus/imubus.h"
+
+#define MOCK_FIFO_BYTES 2048
+#define MOCK_FIFO_FRAMES 256
+
+typedef struct
+{
+    uint8_t regs[128];
+    uint8_t fifo[MOCK_FIFO_BYTES];
+    uint16_t frame_len[MOCK_FIFO_FRAMES]; // 队列中每帧的长度
+    size_t head, bytes;                   // 首帧偏移和总字节数
+    int frame_head, frames;
+
+    uint32_t data_reads;   // FIFO_DATA 读取次数
+    uint32_t length_reads; // FIFO_LENGTH 读取次数
+    size_t bytes_read;     // FIFO_DATA 读出的字节数
+    int fail_reads;        // 大于0时接下来的读取失败
+} mock_bmi270_t;
+
+void mock_bmi270_reset(mock_bmi270_t *dev);
+const imubus_ops_t *mock_bmi270_ops(mock_bmi270_t *dev);
+
+// 入队一个头模式帧
+void mock_bmi270_push(mock_bmi270_t *dev, const uint8_t *frame, size_t len);
+// 入队加速度+陀螺仪数据帧, 原始值为芯片坐标的 LSB
+void mock_bmi270_push_raw(mock_bmi270_t *dev, const int16_t gyr[3], const int16_t acc[3]);
+// 入队加速度+陀螺仪数据帧, 原始值 (芯片坐标) 由 seq 生成: gyr = seq*10 + i, acc = seq*100 + i
+void mock_bmi270_push_acc_gyr(mock_bmi270_t *dev, int16_t seq);
+// 入队溢出丢帧标记
+void mock_bmi270_push_skip(mock_bmi270_t *dev, uint8_t count);
+
+#endif // MOCK_BMI270_H
\ No newline at end of file
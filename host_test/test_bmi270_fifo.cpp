@@ -0,0 +1,201 @@
+// BMI270 FIFO: 头模式解析, 以及对模拟设备的突发读取 (部分帧重发、丢帧标记、读空 0x80、积压追读、输出上限)
+#include "imubus/bmi270_fifo.h"
+#include "mock_bmi270.h"
+#include "test_util.h"
+
+#define WAKEUP_MS 10
+#define BATCH_MAX 24
+
+static mock_bmi270_t dev;
+static bmi270_fifo_t fifo;
+static imu_data_t out[BATCH_MAX];
+
+// 检查样本与 mock_bmi270_push_acc_gyr(seq) 的原始值一致 (经坐标轴映射)
+static void check_sample(const imu_data_t *s, int seq, const bmi270_axis_map_t *map)
+{
+    const float *gyr = &s->gyro_x;
+    const float *acc = &s->accel_x;
+    for (int i = 0; i < 3; i++)
+    {
+        int src = map->src[i];
+        CHECK_NEAR(gyr[i], map->sign[i] * (seq * 10 + src) * fifo.gyr_scale, 1e-4);
+        CHECK_NEAR(acc[i], map->sign[i] * (seq * 100 + src) * fifo.acc_scale, 1e-6);
+    }
+}
+
+static void setup(const bmi270_axis_map_t *map)
+{
+    mock_bmi270_reset(&dev);
+    CHECK(bmi270_fifo_init(&fifo, mock_bmi270_ops(&dev), BMI270_ADDR, BMI270_ODR_400HZ, WAKEUP_MS, map) == 0);
+}
+
+static void test_init(void)
+{
+    mock_bmi270_reset(&dev);
+    dev.regs[BMI270_REG_PWR_CTRL] = 0x01; // M5Unified 已打开 aux
+    mock_bmi270_push_acc_gyr(&dev, 1);
+
+    CHECK(bmi270_fifo_init(&fifo, mock_bmi270_ops(&dev), BMI270_ADDR, BMI270_ODR_400HZ, WAKEUP_MS, &bmi270_axis_identity) == 0);
+    CHECK(dev.regs[BMI270_REG_PWR_CTRL] == 0x07);
+    CHECK(dev.regs[BMI270_REG_ACC_CONF] == (0xA0 | BMI270_ODR_400HZ));
+    CHECK(dev.regs[BMI270_REG_GYR_CONF] == (0xE0 | BMI270_ODR_400HZ));
+    CHECK(dev.regs[BMI270_REG_FIFO_CONFIG_1] == 0xD0);
+    CHECK(dev.frames == 0); // 已清空
+    // 10ms 约4帧, 两倍余量
+    CHECK(fifo.burst_len == (4 * 2 + 1) * BMI270_FIFO_FRAME_ACC_GYR);
+}
+
+// 正常唤醒: 一次突发读取, 读空后的 0x80 结束解析, 不读 FIFO_LENGTH
+static void test_normal(void)
+{
+    setup(&bmi270_axis_identity);
+    for (int seq = 0; seq < 4; seq++)
+    {
+        mock_bmi270_push_acc_gyr(&dev, seq);
+    }
+
+    int n = bmi270_fifo_drain(&fifo, out, BATCH_MAX);
+    CHECK(n == 4);
+    for (int i = 0; i < n; i++)
+    {
+        check_sample(&out[i], i, &bmi270_axis_identity);
+    }
+    CHECK(dev.data_reads == 1);
+    CHECK(dev.length_reads == 0);
+    CHECK(fifo.backlog == 0);
+    CHECK(fifo.frames == 4);
+}
+
+// FIFO为空: 整次读取都是 0x80
+static void test_over_read_end(void)
+{
+    setup(&bmi270_axis_identity);
+    CHECK(bmi270_fifo_drain(&fifo, out, BATCH_MAX) == 0);
+    CHECK(dev.data_reads == 1);
+    CHECK(dev.length_reads == 0);
+
+    // 读空标记之后的字节不再解析, 即使看起来像数据帧
+    uint8_t buf[1 + 2 * BMI270_FIFO_FRAME_ACC_GYR] = {BMI270_FIFO_HEADER_END, 0x8C};
+    imu_data_t last = {};
+    bmi270_fifo_parse_info_t info;
+    CHECK(bmi270_fifo_parse(buf, sizeof(buf), 1.0f, 1.0f, &bmi270_axis_identity, &last, out, BATCH_MAX, &info) == 0);
+    CHECK(info.reached_end);
+    CHECK(info.consumed == 0);
+}
+
+// 丢帧标记使帧边界错位, 突发读取末尾只读到半帧: 追读时整帧重发, 样本不重复不丢失
+static void test_partial_frame(void)
+{
+    setup(&bmi270_axis_identity);
+    mock_bmi270_push_skip(&dev, 3);
+    for (int seq = 0; seq < 10; seq++)
+    {
+        mock_bmi270_push_acc_gyr(&dev, seq);
+    }
+
+    int n = bmi270_fifo_drain(&fifo, out, BATCH_MAX);
+    CHECK(n == 10);
+    for (int i = 0; i < n; i++)
+    {
+        check_sample(&out[i], i, &bmi270_axis_identity);
+    }
+    CHECK(fifo.skipped == 3);
+    CHECK(fifo.backlog == 1);
+    CHECK(dev.length_reads >= 1);
+    CHECK(dev.frames == 0);
+}
+
+// 积压超过输出上限: 只读出能容纳的帧, 其余留在FIFO中下次读取
+static void test_backlog(void)
+{
+    setup(&bmi270_axis_identity);
+    for (int seq = 0; seq < 40; seq++)
+    {
+        mock_bmi270_push_acc_gyr(&dev, seq);
+    }
+
+    int n = bmi270_fifo_drain(&fifo, out, BATCH_MAX);
+    CHECK(n == BATCH_MAX);
+    for (int i = 0; i < n; i++)
+    {
+        check_sample(&out[i], i, &bmi270_axis_identity);
+    }
+    CHECK(fifo.backlog == 1);
+    CHECK(dev.frames == 40 - BATCH_MAX);
+
+    n = bmi270_fifo_drain(&fifo, out, BATCH_MAX);
+    CHECK(n == 40 - BATCH_MAX);
+    for (int i = 0; i < n; i++)
+    {
+        check_sample(&out[i], BATCH_MAX + i, &bmi270_axis_identity);
+    }
+    CHECK(dev.frames == 0);
+    CHECK(fifo.frames == 40);
+}
+
+static void test_read_error(void)
+{
+    setup(&bmi270_axis_identity);
+    mock_bmi270_push_acc_gyr(&dev, 1);
+    dev.fail_reads = 1;
+    CHECK(bmi270_fifo_drain(&fifo, out, BATCH_MAX) == -1);
+    CHECK(bmi270_fifo_drain(&fifo, out, BATCH_MAX) == 1);
+}
+
+// AtomS3R 映射: X、Z 取反, 加速度和陀螺仪相同
+static void test_axis_map(void)
+{
+    setup(&bmi270_axis_atoms3r);
+    mock_bmi270_push_acc_gyr(&dev, 2);
+    CHECK(bmi270_fifo_drain(&fifo, out, BATCH_MAX) == 1);
+    check_sample(&out[0], 2, &bmi270_axis_atoms3r);
+    CHECK(out[0].accel_x < 0.0f && out[0].accel_y > 0.0f && out[0].accel_z < 0.0f);
+
+    // 轴交换
+    const bmi270_axis_map_t swap = {{1, 0, 2}, {1, -1, 1}};
+    setup(&swap);
+    mock_bmi270_push_acc_gyr(&dev, 2);
+    CHECK(bmi270_fifo_drain(&fifo, out, BATCH_MAX) == 1);
+    check_sample(&out[0], 2, &swap);
+}
+
+// 控制帧跳过; 只含加速度的帧沿用上一帧的陀螺仪; 无法识别的控制帧停止解析
+static void test_parse_frames(void)
+{
+    uint8_t buf[] = {
+        0x8C, 10, 0, 20, 0, 30, 0, 1, 0, 2, 0, 3, 0, // 陀螺仪 + 加速度
+        BMI270_FIFO_HEADER_TIME, 1, 2, 3,
+        BMI270_FIFO_HEADER_CONFIG, 0, 0, 0, 0,
+        0x84, 4, 0, 5, 0, 6, 0, // 只含加速度
+        0x50, 0,                // 无法识别
+        0x84, 7, 0, 8, 0, 9, 0};
+    imu_data_t last = {};
+    bmi270_fifo_parse_info_t info;
+
+    int n = bmi270_fifo_parse(buf, sizeof(buf), 1.0f, 1.0f, &bmi270_axis_identity, &last, out, BATCH_MAX, &info);
+    CHECK(n == 2);
+    CHECK(!info.reached_end);
+    CHECK(info.consumed == 13 + 4 + 5 + 7);
+    CHECK_NEAR(out[1].accel_x, 4.0f, 1e-6);
+    CHECK_NEAR(out[1].gyro_x, 10.0f, 1e-6);
+    CHECK_NEAR(out[1].gyro_z, 30.0f, 1e-6);
+
+    // 不完整的控制帧不计入 consumed
+    uint8_t partial[] = {BMI270_FIFO_HEADER_SKIP};
+    CHECK(bmi270_fifo_parse(partial, sizeof(partial), 1.0f, 1.0f, &bmi270_axis_identity, &last, out, BATCH_MAX, &info) == 0);
+    CHECK(info.consumed == 0);
+    CHECK(info.skipped == 0);
+}
+
+int main()
+{
+    test_init();
+    test_normal();
+    test_over_read_end();
+    test_partial_frame();
+    test_backlog();
+    test_read_error();
+    test_axis_map();
+    test_parse_frames();
+    return test_result("test_bmi270_fifo");
+}
@@ -0,0 +1,128 @@
+// 总线仲裁: 所有者线程直接执行, 其他线程的请求排队, 只在所有者调用 imubus_service 时执行
+#include "imubus/imubus.h"
+#include "memstat/memstat.h"
+#include "test_util.h"
+#include <atomic>
+#include <thread>
+
+#define CLIENTS 3
+#define REQUESTS_PER_CLIENT 200
+
+static std::thread::id owner_id;
+static std::atomic<int> foreign_calls(0); // 在所有者以外的线程上访问总线的次数
+static uint8_t regs[256];
+
+// 登记在主机上不需要
+void memstat_register_pool(const char *name, size_t bytes)
+{
+}
+
+static int fake_read(void *ctx, uint8_t dev_addr, uint8_t reg, uint8_t *buf, size_t len)
+{
+    if (std::this_thread::get_id() != owner_id)
+    {
+        foreign_calls++;
+    }
+    for (size_t i = 0; i < len; i++)
+    {
+        buf[i] = regs[(uint8_t)(reg + i)];
+    }
+    return dev_addr == 0x68 ? 0 : -1;
+}
+
+static int fake_write(void *ctx, uint8_t dev_addr, uint8_t reg, const uint8_t *buf, size_t len)
+{
+    if (std::this_thread::get_id() != owner_id)
+    {
+        foreign_calls++;
+    }
+    for (size_t i = 0; i < len; i++)
+    {
+        regs[(uint8_t)(reg + i)] = buf[i];
+    }
+    return 0;
+}
+
+static const imubus_ops_t fake_ops = {fake_read, fake_write, NULL};
+
+static void client(int id, int *errors)
+{
+    for (int i = 0; i < REQUESTS_PER_CLIENT; i++)
+    {
+        // 每个客户端只写自己的寄存器, 再读回
+        uint8_t reg = (uint8_t)(0x10 + id);
+        uint8_t value = (uint8_t)(i + id);
+        uint8_t back = 0;
+        if (imubus_write(0x68, reg, &value, 1) != 0 || imubus_read(0x68, reg, &back, 1) != 0 || back != value)
+        {
+            (*errors)++;
+        }
+    }
+}
+
+static void test_arbitration(void)
+{
+    owner_id = std::this_thread::get_id();
+    CHECK(imubus_init(&fake_ops) == 0);
+
+    // 所有者线程内直接执行
+    uint8_t value = 0x5A, back = 0;
+    CHECK(imubus_write(0x68, 0x01, &value, 1) == 0);
+    CHECK(imubus_read(0x68, 0x01, &back, 1) == 0);
+    CHECK(back == 0x5A);
+    CHECK(imubus_read(0x30, 0x01, &back, 1) == -1);
+
+    int errors[CLIENTS] = {0};
+    std::atomic<bool> done(false);
+    std::thread clients[CLIENTS];
+    for (int c = 0; c < CLIENTS; c++)
+    {
+        clients[c] = std::thread(client, c, &errors[c]);
+    }
+    std::thread joiner([&] {
+        for (auto &t : clients)
+        {
+            t.join();
+        }
+        done = true;
+    });
+
+    // 模拟 imu_task 的唤醒循环
+    while (!done)
+    {
+        imubus_service();
+        std::this_thread::yield();
+    }
+    joiner.join();
+    imubus_service();
+
+    for (int c = 0; c < CLIENTS; c++)
+    {
+        CHECK(errors[c] == 0);
+    }
+    CHECK(foreign_calls == 0);
+
+    imubus_stats_t stats;
+    imubus_get_stats(&stats);
+    CHECK(stats.queued == CLIENTS * REQUESTS_PER_CLIENT * 2);
+    CHECK(stats.transactions == CLIENTS * REQUESTS_PER_CLIENT * 2 + 3);
+    CHECK(stats.errors == 1);
+    printf("仲裁: %d个线程排队%lu次请求, 全部在所有者线程执行\n", CLIENTS, (unsigned long)stats.queued);
+}
+
+// 经过仲裁的 ops 与直接调用等价, 供 bmi270_fifo 使用
+static void test_arbitrated_ops(void)
+{
+    const imubus_ops_t *ops = imubus_arbitrated_ops();
+    uint8_t value = 0x33, back = 0;
+    CHECK(ops->write(ops->ctx, 0x68, 0x02, &value, 1) == 0);
+    CHECK(ops->read(ops->ctx, 0x68, 0x02, &back, 1) == 0);
+    CHECK(back == 0x33);
+}
+
+int main()
+{
+    test_arbitration();
+    test_arbitrated_ops();
+    return test_result("test_imubus");
+}
@@ -0,0 +1,259 @@
+// 乐句识别: 重叠和后缀乐句经字典链接输出、间隔/总时长窗口、输出截断、重复构建,
+// 以及几百个乐句时每个事件的耗时与乐句数无关
+#include "phrase/phrase.h"
+#include "test_util.h"
+#include <chrono>
+
+#define UP ACTION_TILT_UP
+#define DOWN ACTION_TILT_DOWN
+
+// 本次事件是否输出了 tag
+static int count_tag(const phrase_match_t *matches, int n, uint32_t tag)
+{
+    int count = 0;
+    for (int i = 0; i < n; i++)
+    {
+        count += matches[i].tag == tag;
+    }
+    return count;
+}
+
+// 重叠与后缀: "UP DOWN" 的状态上输出自己, 后缀 "DOWN" 经字典链接输出;
+// "HAND_UP DOWN" 本身不是乐句, 后缀 "DOWN" 同样要输出
+static void test_overlap_suffix(void)
+{
+    const simple_action_t ab[] = {UP, DOWN};
+    const simple_action_t b[] = {DOWN};
+    const simple_action_t aba[] = {UP, DOWN, UP};
+    const simple_action_t ba[] = {DOWN, UP};
+
+    phrase_clear();
+    phrase_add(ab, 2, 1000, 5000, 1);
+    phrase_add(b, 1, 1000, 5000, 2);
+    phrase_add(aba, 3, 1000, 5000, 3);
+    phrase_add(ba, 2, 1000, 5000, 4);
+    CHECK(phrase_build());
+
+    phrase_match_t m[8];
+    int n = phrase_feed(UP, 0, m, 8);
+    CHECK(n == 0);
+
+    n = phrase_feed(DOWN, 100, m, 8);
+    CHECK(n == 2);
+    CHECK(count_tag(m, n, 1) == 1);
+    CHECK(count_tag(m, n, 2) == 1);
+
+    n = phrase_feed(UP, 200, m, 8);
+    CHECK(n == 2);
+    CHECK(count_tag(m, n, 3) == 1);
+    CHECK(count_tag(m, n, 4) == 1);
+    for (int i = 0; i < n; i++)
+    {
+        CHECK(m[i].end_time == 200);
+        CHECK(m[i].start_time == (m[i].tag == 3 ? 0u : 100u));
+    }
+
+    // 重叠继续: "DOWN UP" 之后再 DOWN, 又完成 "UP DOWN" 和 "DOWN"
+    n = phrase_feed(DOWN, 300, m, 8);
+    CHECK(n == 2);
+    CHECK(count_tag(m, n, 1) == 1 && count_tag(m, n, 2) == 1);
+
+    // 中间状态本身没有输出
+    phrase_reset_stream();
+    n = phrase_feed(HAND_UP, 400, m, 8);
+    CHECK(n == 0);
+    n = phrase_feed(DOWN, 500, m, 8);
+    CHECK(n == 1 && m[0].tag == 2);
+}
+
+// 时间窗: 相邻间隔超过 max_gap_ms 或整体超过 max_total_ms 都不输出
+static void test_timing(void)
+{
+    const simple_action_t seq[] = {HAND_UP, PING_SHANGJU, HAND_DOWN};
+
+    phrase_clear();
+    phrase_add(seq, 3, 100, 150, 7);
+    CHECK(phrase_build());
+
+    phrase_match_t m[4];
+    struct
+    {
+        uint32_t t[3];
+        int expect;
+        const char *name;
+    } cases[] = {
+        {{1000, 1070, 1140}, 1, "间隔70 总长140"},
+        {{1000, 1100, 1150}, 1, "间隔正好100 总长正好150"},
+        {{1000, 1101, 1150}, 0, "间隔101"},
+        {{1000, 1050, 1151}, 0, "第二个间隔101"},
+        {{1000, 1080, 1160}, 0, "间隔都在80内, 总长160"},
+    };
+
+    for (auto &c : cases)
+    {
+        phrase_reset_stream();
+        int n = 0;
+        for (int i = 0; i < 3; i++)
+        {
+            n = phrase_feed(seq[i], c.t[i], m, 4);
+        }
+        CHECK(n == c.expect);
+        if (n == 1)
+        {
+            CHECK(m[0].start_time == c.t[0] && m[0].end_time == c.t[2]);
+        }
+        printf("[时间窗] %s: %s\n", c.name, n ? "输出" : "拒绝");
+    }
+
+    // 动作流里较早的无关动作不影响窗口
+    phrase_reset_stream();
+    phrase_feed(UP, 0, m, 4);
+    phrase_feed(HAND_UP, 5000, m, 4);
+    phrase_feed(PING_SHANGJU, 5050, m, 4);
+    CHECK(phrase_feed(HAND_DOWN, 5100, m, 4) == 1);
+}
+
+// 同一事件完成的乐句多于 max_matches 时按容量截断, 不越界
+static void test_truncation(void)
+{
+    const simple_action_t up[] = {UP};
+    const simple_action_t down_up[] = {DOWN, UP};
+    const simple_action_t down_down_up[] = {DOWN, DOWN, UP};
+
+    phrase_clear();
+    phrase_add(up, 1, 1000, 5000, 1);
+    phrase_add(up, 1, 1000, 5000, 2); // 同一序列的第二个乐句, 挂在同一状态上
+    phrase_add(down_up, 2, 1000, 5000, 3);
+    phrase_add(down_down_up, 3, 1000, 5000, 4);
+    CHECK(phrase_build());
+
+    const simple_action_t stream[] = {DOWN, DOWN, UP};
+    for (int cap = 0; cap <= 5; cap++)
+    {
+        phrase_match_t m[6];
+        m[cap].tag = 0xDEAD; // 哨兵, 不能被写
+
+        phrase_reset_stream();
+        int n = 0;
+        for (int i = 0; i < 3; i++)
+        {
+            n = phrase_feed(stream[i], (uint32_t)i * 100, m, cap);
+        }
+        CHECK(n == (cap < 4 ? cap : 4));
+        CHECK(m[cap].tag == 0xDEAD);
+        for (int i = 0; i < n; i++)
+        {
+            CHECK(count_tag(m, n, m[i].tag) == 1);
+        }
+    }
+}
+
+// 重复构建返回 false, 不破坏已构建的自动机; clear 后可以重新构建
+static void test_build_twice(void)
+{
+    const simple_action_t seq[] = {UP, DOWN};
+    phrase_match_t m[4];
+
+    phrase_clear();
+    phrase_add(seq, 2, 1000, 5000, 9);
+    CHECK(phrase_build());
+    CHECK(!phrase_build());
+    CHECK(phrase_add(seq, 2, 1000, 5000, 10) == -1);
+
+    phrase_feed(UP, 0, m, 4);
+    CHECK(phrase_feed(DOWN, 100, m, 4) == 1 && m[0].tag == 9);
+
+    phrase_clear();
+    phrase_add(seq, 2, 1000, 5000, 11);
+    CHECK(phrase_build());
+    phrase_feed(UP, 0, m, 4);
+    CHECK(phrase_feed(DOWN, 100, m, 4) == 1 && m[0].tag == 11);
+}
+
+// 确定性的伪随机动作
+static simple_action_t random_action(uint32_t *state)
+{
+    *state = *state * 1664525u + 1013904223u;
+    return (simple_action_t)((*state >> 16) % PHRASE_ALPHABET);
+}
+
+// 注册 count 个长度为 PHRASE_MAX_LEN 的随机乐句, 返回随机动作流上每个事件的耗时(ns)
+static double feed_cost_ns(int count)
+{
+    uint32_t seed = 2024;
+    phrase_clear();
+    for (int i = 0; i < count; i++)
+    {
+        simple_action_t seq[PHRASE_MAX_LEN];
+        for (int k = 0; k < PHRASE_MAX_LEN; k++)
+        {
+            seq[k] = random_action(&seed);
+        }
+        CHECK(phrase_add(seq, PHRASE_MAX_LEN, 1000, 10000, (uint32_t)i) == i);
+    }
+    CHECK(phrase_build());
+
+    const int events = 2000000;
+    phrase_match_t m[4];
+    int total = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < events; i++)
+    {
+        total += phrase_feed(random_action(&seed), (uint32_t)i, m, 4);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / events;
+    printf("[规模] %d个乐句: %.1fns/事件, 匹配%d次\n", count, ns, total);
+    return ns;
+}
+
+// 几百个乐句: 每个乐句都能被识别且只输出一次; 每个事件的耗时不随乐句数增长
+static void test_scaling(void)
+{
+    // 长度4的全部序列中取前 PHRASE_MAX_PHRASES 个, 编号即 tag
+    phrase_clear();
+    simple_action_t seqs[PHRASE_MAX_PHRASES][4];
+    for (int i = 0; i < PHRASE_MAX_PHRASES; i++)
+    {
+        int v = i;
+        for (int k = 3; k >= 0; k--)
+        {
+            seqs[i][k] = (simple_action_t)(v % PHRASE_ALPHABET);
+            v /= PHRASE_ALPHABET;
+        }
+        CHECK(phrase_add(seqs[i], 4, 1000, 5000, (uint32_t)i) == i);
+    }
+    CHECK(phrase_add(seqs[0], 4, 1000, 5000, 0) == -1); // 超过 PHRASE_MAX_PHRASES
+    CHECK(phrase_build());
+
+    int recognized = 0;
+    for (int i = 0; i < PHRASE_MAX_PHRASES; i++)
+    {
+        phrase_match_t m[4];
+        phrase_reset_stream();
+        int n = 0;
+        for (int k = 0; k < 4; k++)
+        {
+            n = phrase_feed(seqs[i][k], (uint32_t)k * 100, m, 4);
+        }
+        recognized += n == 1 && m[0].tag == (uint32_t)i;
+    }
+    CHECK(recognized == PHRASE_MAX_PHRASES);
+    printf("[规模] %d个乐句全部识别: %s\n", PHRASE_MAX_PHRASES, recognized == PHRASE_MAX_PHRASES ? "是" : "否");
+
+    // 随机动作流几乎不会完成长度8的乐句, 耗时只反映查表; 允许缓存等因素带来的3倍以内差异
+    double small = feed_cost_ns(4);
+    double large = feed_cost_ns(PHRASE_MAX_PHRASES);
+    CHECK(large < small * 3.0);
+}
+
+int main()
+{
+    test_overlap_suffix();
+    test_timing();
+    test_truncation();
+    test_build_twice();
+    test_scaling();
+    return test_result("test_phrase");
+}
@@ -0,0 +1,138 @@
+// 倾斜四元数: roll/pitch 往返、pitch -90° 附近的roll翻转、重力朝 -Z 的反向分支
+#include "quat/quat.h"
+#include "test_util.h"
+
+static float quat_norm(const quat_t *q)
+{
+    return sqrtf(q->w * q->w + q->x * q->x + q->y * q->y + q->z * q->z);
+}
+
+// 与 quat_from_roll_pitch 相同约定的重力方向
+static void gravity_from_roll_pitch(float roll_deg, float pitch_deg, float *gx, float *gy, float *gz)
+{
+    float r = roll_deg * (float)M_PI / 180.0f;
+    float p = pitch_deg * (float)M_PI / 180.0f;
+    *gx = -sinf(p);
+    *gy = cosf(p) * sinf(r);
+    *gz = cosf(p) * cosf(r);
+}
+
+// 两个重力方向的夹角(度)
+static float gravity_angle_deg(float ax, float ay, float az, float bx, float by, float bz)
+{
+    float d = fmaxf(-1.0f, fminf(1.0f, ax * bx + ay * by + az * bz));
+    return acosf(d) * 180.0f / (float)M_PI;
+}
+
+static void test_round_trip(void)
+{
+    // pitch -80°: roll 仍有定义, 往返应还原
+    for (float roll = -170.0f; roll <= 170.0f; roll += 10.0f)
+    {
+        quat_t q = quat_from_roll_pitch(roll, -80.0f);
+        float r, p;
+        quat_to_roll_pitch(&q, &r, &p);
+
+        CHECK_NEAR(quat_norm(&q), 1.0f, 1e-5);
+        CHECK_NEAR(p, -80.0f, 0.01);
+        CHECK_NEAR(r, roll, 0.05);
+    }
+
+    // pitch -90°: roll 无定义, 任意roll都得到同一姿态, 往返返回 roll = 0
+    for (float roll = -170.0f; roll <= 170.0f; roll += 20.0f)
+    {
+        quat_t q = quat_from_roll_pitch(roll, -90.0f);
+        quat_t ref = quat_from_roll_pitch(0.0f, -90.0f);
+        float r, p;
+        quat_to_roll_pitch(&q, &r, &p);
+
+        CHECK_NEAR(quat_norm(&q), 1.0f, 1e-5);
+        CHECK_NEAR(p, -90.0f, 0.05);
+        CHECK_NEAR(r, 0.0f, 1e-3);
+        CHECK_NEAR(quat_geodesic_deg(&q, &ref), 0.0f, 0.1);
+    }
+
+    // 四元数 -> 重力方向 与直接计算一致
+    float gx, gy, gz, hx, hy, hz;
+    quat_t q = quat_from_roll_pitch(30.0f, -80.0f);
+    quat_to_gravity(&q, &gx, &gy, &gz);
+    gravity_from_roll_pitch(30.0f, -80.0f, &hx, &hy, &hz);
+    CHECK_NEAR(gravity_angle_deg(gx, gy, gz, hx, hy, hz), 0.0f, 0.05);
+}
+
+static void test_roll_flip(void)
+{
+    // pitch -80° 时 roll ±40° 欧拉角相差80°, 重力方向只差 2*asin(cos80°*sin40°) ≈ 12.8°
+    // 倾斜四元数之间还含一小段绕Z的扭转, 测地距离略大于重力夹角, 但远小于80°
+    quat_t a = quat_from_roll_pitch(40.0f, -80.0f);
+    quat_t b = quat_from_roll_pitch(-40.0f, -80.0f);
+    float tilt_deg = 2.0f * asinf(cosf(80.0f * (float)M_PI / 180.0f) * sinf(40.0f * (float)M_PI / 180.0f)) * 180.0f / (float)M_PI;
+    float geo_deg = quat_geodesic_deg(&a, &b);
+    CHECK(geo_deg >= tilt_deg - 0.05f);
+    CHECK(geo_deg < 20.0f);
+    CHECK_NEAR(quat_approx_angle(&a, &b) * 180.0f / (float)M_PI, geo_deg, 0.2);
+
+    // 25° 容差的模板 (举手的起始点) 同时接受两者, 欧拉角加权距离会拒绝
+    quat_point_t point = quat_point_from_roll_pitch(40.0f, -80.0f, 25.0f);
+    CHECK(quat_point_matches(&a, &point));
+    CHECK(quat_point_matches(&b, &point));
+
+    // roll 跨越 ±180°: 欧拉角差340°, 实际只差几度
+    quat_t c = quat_from_roll_pitch(170.0f, -80.0f);
+    quat_t d = quat_from_roll_pitch(-170.0f, -80.0f);
+    CHECK(quat_geodesic_deg(&c, &d) < 6.0f);
+
+    // 越接近 -90°, roll 翻转对应的姿态差越小且连续
+    float prev = 1e9f;
+    for (float pitch = -80.0f; pitch >= -89.0f; pitch -= 1.0f)
+    {
+        quat_t e = quat_from_roll_pitch(40.0f, pitch);
+        quat_t f = quat_from_roll_pitch(-40.0f, pitch);
+        float angle = quat_geodesic_deg(&e, &f);
+        CHECK(angle < prev);
+        prev = angle;
+    }
+    quat_t e = quat_from_roll_pitch(40.0f, -89.9f);
+    quat_t f = quat_from_roll_pitch(-40.0f, -89.9f);
+    CHECK(quat_geodesic_deg(&e, &f) < 0.5f);
+}
+
+static void test_antipodal(void)
+{
+    // 重力正好朝 -Z: 取绕X轴180°的分支
+    quat_t q = quat_from_gravity(0.0f, 0.0f, -1.0f);
+    float gx, gy, gz;
+    quat_to_gravity(&q, &gx, &gy, &gz);
+    CHECK_NEAR(quat_norm(&q), 1.0f, 1e-6);
+    CHECK_NEAR(gz, -1.0f, 1e-6);
+
+    // 从不同方向逼近 -Z: 结果始终是单位四元数且往返误差很小 (分支附近方向不连续, 但姿态正确)
+    for (int k = 0; k < 8; k++)
+    {
+        float az = (float)k * (float)M_PI / 4.0f;
+        for (float eps = 1e-1f; eps > 1e-7f; eps *= 0.1f)
+        {
+            float hx = eps * cosf(az);
+            float hy = eps * sinf(az);
+            float hz = -sqrtf(1.0f - eps * eps);
+
+            quat_t p = quat_from_gravity(hx, hy, hz);
+            quat_to_gravity(&p, &gx, &gy, &gz);
+            CHECK_NEAR(quat_norm(&p), 1.0f, 1e-5);
+            CHECK(gravity_angle_deg(gx, gy, gz, hx, hy, hz) < 0.1f);
+        }
+    }
+
+    // pitch 0, roll 180 (倒置) 经 roll/pitch 入口同样落在这个分支
+    quat_t inv = quat_from_roll_pitch(180.0f, 0.0f);
+    quat_to_gravity(&inv, &gx, &gy, &gz);
+    CHECK_NEAR(gz, -1.0f, 1e-5);
+}
+
+int main()
+{
+    test_round_trip();
+    test_roll_flip();
+    test_antipodal();
+    return test_result("test_quat");
+}
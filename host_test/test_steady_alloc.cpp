@@ -0,0 +1,226 @@
+// 稳态零分配: 替换 malloc 系列计数, 预热后运行主机可编译的整条处理链
+// (FIFO读取 -> 滤波器组 -> 滑动DFT -> 倾斜四元数 -> 三点预测检测 -> 乐句 -> 组网合并), 期间不允许任何堆分配
+#include "imubus/bmi270_fifo.h"
+#include "filterbank/filterbank.h"
+#include "spectral/spectral.h"
+#include "phrase/phrase.h"
+#include "bodynet/bodynet.h"
+#include "mock_bmi270.h"
+#include "test_util.h"
+#include <stdlib.h>
+
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t n, size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t size);
+extern "C" void __libc_free(void *ptr);
+
+static bool counting = false;
+static uint32_t alloc_count = 0;
+static size_t alloc_bytes = 0;
+
+static void count_alloc(size_t size)
+{
+    if (counting)
+    {
+        alloc_count++;
+        alloc_bytes += size;
+    }
+}
+
+extern "C" void *malloc(size_t size)
+{
+    count_alloc(size);
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t n, size_t size)
+{
+    count_alloc(n * size);
+    return __libc_calloc(n, size);
+}
+
+extern "C" void *realloc(void *ptr, size_t size)
+{
+    count_alloc(size);
+    return __libc_realloc(ptr, size);
+}
+
+extern "C" void free(void *ptr)
+{
+    __libc_free(ptr);
+}
+
+#define WAKEUP_US 10000 // imu_task 唤醒周期
+#define FRAMES_PER_WAKEUP 4
+#define BATCH_MAX 24
+#define GESTURE_US 1500000 // 一次向下倾斜再回正
+#define ACC_LSB_PER_G 4096.0f
+
+static mock_bmi270_t dev;
+static bmi270_fifo_t fifo;
+static bodynet_loopback_bus_t bus;
+static bodynet_loopback_port_t ports[2];
+static bodynet_hub_t hub;
+static bodynet_node_t node;
+static int64_t sim_us = 0;
+
+static uint32_t sim_clock_ms(void)
+{
+    return (uint32_t)(sim_us / 1000);
+}
+
+static int64_t arrival_clock(uint8_t node_id)
+{
+    return sim_us;
+}
+
+// 每个手势周期内 roll 0 -> -55 -> 0
+static float roll_at(int64_t t_us)
+{
+    float phase = (float)(t_us % GESTURE_US) / GESTURE_US;
+    return phase < 0.5f ? -110.0f * phase : -110.0f * (1.0f - phase);
+}
+
+static filterbank_t filters = {
+    .b0 = {0.09f, 0.09f, 0.09f, 1.0f, 1.0f, 1.0f, 0.06f, 0.06f, 0.06f},
+    .b1 = {0},
+    .b2 = {0},
+    .a1 = {-0.91f, -0.91f, -0.91f, 0.0f, 0.0f, 0.0f, -0.94f, -0.94f, -0.94f},
+    .a2 = {0},
+    .z1 = {0},
+    .z2 = {0},
+    .first_order = true,
+    .primed = false};
+
+static int notes = 0;
+
+// 模拟 imu_task 一次唤醒加 app_main 对这批样本的处理
+static void run_wakeup(void)
+{
+    static imu_data_t batch[BATCH_MAX];
+    static imu_data_t decim;
+    static int decim_count = 0;
+    spectral_features_t features;
+
+    for (int i = 0; i < FRAMES_PER_WAKEUP; i++)
+    {
+        float r = roll_at(sim_us + i * (WAKEUP_US / FRAMES_PER_WAKEUP)) * (float)M_PI / 180.0f;
+        int16_t gyr[3] = {(int16_t)(i * 3), 0, 0};
+        int16_t acc[3] = {0, (int16_t)(sinf(r) * ACC_LSB_PER_G), (int16_t)(cosf(r) * ACC_LSB_PER_G)};
+        mock_bmi270_push_raw(&dev, gyr, acc);
+    }
+
+    int n = bmi270_fifo_drain(&fifo, batch, BATCH_MAX);
+    for (int i = 0; i < n; i++)
+    {
+        float *sum = &decim.accel_x;
+        const float *x = &batch[i].accel_x;
+        for (int c = 0; c < 9; c++)
+        {
+            sum[c] += x[c];
+        }
+        if (++decim_count == 8)
+        {
+            for (int c = 0; c < 9; c++)
+            {
+                sum[c] /= 8;
+            }
+            spectral_push(&decim, &features);
+            decim = imu_data_t();
+            decim_count = 0;
+        }
+    }
+    filterbank_set_lowpass_alpha(&filters, FILTERBANK_ACCEL, 0.09f);
+    filterbank_process(&filters, batch, batch, n);
+
+    for (int i = 0; i < n; i++)
+    {
+        const imu_data_t *d = &batch[i];
+        float norm = sqrtf(d->accel_x * d->accel_x + d->accel_y * d->accel_y + d->accel_z * d->accel_z);
+        imu_euler_t euler;
+        euler.tilt = quat_from_gravity(d->accel_x / norm, d->accel_y / norm, d->accel_z / norm);
+        quat_to_roll_pitch(&euler.tilt, &euler.roll, &euler.pitch);
+        euler.yaw = 0.0f;
+        euler.gyro_x = d->gyro_x;
+        euler.gyro_y = d->gyro_y;
+        euler.gyro_z = d->gyro_z;
+
+        simple_action_t action;
+        uint32_t execution_time;
+        note_duration_t note_type;
+        note_event_t event = detect_three_point_predictive(&euler, &action, &execution_time, &note_type);
+        if (event == NOTE_EVENT_CONFIRM || event == NOTE_EVENT_TRIGGER)
+        {
+            phrase_match_t matches[4];
+            phrase_feed(action, sim_clock_ms(), matches, 4);
+            notes++;
+        }
+
+        int64_t t = sim_us - (int64_t)(n - 1 - i) * (WAKEUP_US / FRAMES_PER_WAKEUP);
+        bodynet_hub_push_local(&hub, t, d);
+        bodynet_node_push_sample(&node, t + 5000000, d);
+    }
+
+    bodynet_node_poll(&node, sim_us + 5000000);
+    bodynet_hub_poll(&hub, sim_us);
+    bodynet_frame_t frame;
+    while (bodynet_hub_pop_frame(&hub, sim_us, &frame))
+    {
+    }
+}
+
+static void setup(void)
+{
+    mock_bmi270_reset(&dev);
+    bmi270_fifo_init(&fifo, mock_bmi270_ops(&dev), BMI270_ADDR, BMI270_ODR_400HZ, WAKEUP_US / 1000, &bmi270_axis_identity);
+    spectral_init(50.0f, 8);
+    three_point_set_clock(sim_clock_ms);
+    reset_three_point_detector();
+
+    const simple_action_t seq[] = {ACTION_TILT_DOWN, ACTION_TILT_DOWN};
+    phrase_clear();
+    phrase_add(seq, 2, 3000, 5000, 0);
+    phrase_build();
+
+    bodynet_loopback_init(&bus, arrival_clock);
+    bodynet_transport_t hub_transport = bodynet_loopback_transport(&ports[0], &bus, 0);
+    bodynet_transport_t node_transport = bodynet_loopback_transport(&ports[1], &bus, 1);
+    bodynet_hub_init(&hub, 0, 0x03, 50000, &hub_transport);
+    bodynet_node_init(&node, 1, 0, &node_transport);
+}
+
+static void run(int64_t duration_us)
+{
+    for (int64_t end = sim_us + duration_us; sim_us < end; sim_us += WAKEUP_US)
+    {
+        run_wakeup();
+    }
+}
+
+int main()
+{
+    // 计数本身有效: 稳态中的一次 malloc 必须被发现
+    void *(*volatile do_malloc)(size_t) = malloc;
+    counting = true;
+    void *p = do_malloc(32);
+    counting = false;
+    free(p);
+    CHECK(alloc_count == 1);
+    alloc_count = 0;
+    alloc_bytes = 0;
+
+    setup();
+    run(3 * GESTURE_US); // 预热: 首次打印等一次性分配
+
+    int warm_notes = notes;
+    counting = true;
+    run(20 * GESTURE_US);
+    counting = false;
+
+    printf("稳态: %d个手势, 发出%d个音, 组网帧%lu, 堆分配%lu次 %lu字节\n", 20, notes - warm_notes,
+           (unsigned long)hub.stats.frames_out, (unsigned long)alloc_count, (unsigned long)alloc_bytes);
+    CHECK(notes - warm_notes >= 10);     // 处理链确实在工作
+    CHECK(hub.stats.frames_out > 0);
+    CHECK(alloc_count == 0);
+    return test_result("test_steady_alloc");
+}
@@ -0,0 +1,391 @@
+// 三点检测预测触发的轨迹回放: 统计提前起音的准确率、节省的延迟和取消延迟
+//   test_three_point            回放内置的合成轨迹并检查结果
+//   test_three_point trace.csv  回放录制的轨迹, 每行 "t_ms,roll,pitch[,gyro_x,gyro_y,gyro_z]",
+//                               没有陀螺仪列时由相邻样本差分得到
+#include "imu/imu.h"
+#include "test_util.h"
+#include <stdlib.h>
+
+#define TRACE_MAX 2048
+
+typedef struct
+{
+    uint32_t t_ms;
+    float roll, pitch;
+    float gyro[3]; // 机体角速度 (度/秒)
+} trace_point_t;
+
+typedef struct
+{
+    uint32_t t_ms;
+    float roll, pitch;
+} keyframe_t;
+
+// 回放结果, 时间相对轨迹起点
+typedef struct
+{
+    int onsets, confirms, cancels, triggers;
+    uint32_t onset_ms, note_ms, cancel_ms;
+} replay_result_t;
+
+static uint32_t sim_time_ms = 0;
+
+static uint32_t sim_clock(void)
+{
+    return sim_time_ms;
+}
+
+// 确定性的 ±amp 噪声
+static float noise(uint32_t *state, float amp)
+{
+    *state = *state * 1664525u + 1013904223u;
+    return ((float)(*state >> 8) / (float)(1 << 24) * 2.0f - 1.0f) * amp;
+}
+
+// 两个姿态之间的机体角速度 (度/秒): 重力方向 dg/dt = g × ω, 取垂直于 g 的最小解 ω = dg/dt × g
+static void body_rate(float roll0, float pitch0, float roll1, float pitch1, float dt_ms, float *gyro)
+{
+    quat_t q0 = quat_from_roll_pitch(roll0, pitch0);
+    quat_t q1 = quat_from_roll_pitch(roll1, pitch1);
+    float g0[3], g1[3], dg[3];
+    quat_to_gravity(&q0, &g0[0], &g0[1], &g0[2]);
+    quat_to_gravity(&q1, &g1[0], &g1[1], &g1[2]);
+    for (int i = 0; i < 3; i++)
+    {
+        dg[i] = (g1[i] - g0[i]) / (dt_ms * 0.001f) * 57.29578f;
+    }
+    gyro[0] = dg[1] * g0[2] - dg[2] * g0[1];
+    gyro[1] = dg[2] * g0[0] - dg[0] * g0[2];
+    gyro[2] = dg[0] * g0[1] - dg[1] * g0[0];
+}
+
+// 关键帧线性插值
+static void pose_at(const keyframe_t *keys, int num_keys, float t, float *roll, float *pitch)
+{
+    int k = 0;
+    while (k < num_keys - 2 && t >= (float)keys[k + 1].t_ms)
+    {
+        k++;
+    }
+    float span = (float)(keys[k + 1].t_ms - keys[k].t_ms);
+    float w = span > 0.0f ? fminf(1.0f, (t - (float)keys[k].t_ms) / span) : 1.0f;
+    *roll = keys[k].roll + (keys[k + 1].roll - keys[k].roll) * w;
+    *pitch = keys[k].pitch + (keys[k + 1].pitch - keys[k].pitch) * w;
+}
+
+// 关键帧插值成固定步长的轨迹; 姿态加 ±noise_deg 噪声, 陀螺仪取无噪声轨迹的角速度加 ±2度/秒噪声
+static int build_trace(const keyframe_t *keys, int num_keys, uint32_t step_ms, float noise_deg, trace_point_t *out)
+{
+    uint32_t seed = 12345;
+    int n = 0;
+    for (uint32_t t = 0; t <= keys[num_keys - 1].t_ms && n < TRACE_MAX; t += step_ms)
+    {
+        float roll, pitch, roll1, pitch1;
+        pose_at(keys, num_keys, (float)t, &roll, &pitch);
+        pose_at(keys, num_keys, (float)t + 0.5f, &roll1, &pitch1);
+
+        out[n].t_ms = t;
+        out[n].roll = roll + noise(&seed, noise_deg);
+        out[n].pitch = pitch + noise(&seed, noise_deg);
+        body_rate(roll, pitch, roll1, pitch1, 0.5f, out[n].gyro);
+        for (int i = 0; i < 3; i++)
+        {
+            out[n].gyro[i] += noise(&seed, 2.0f);
+        }
+        n++;
+    }
+    return n;
+}
+
+static replay_result_t replay(const trace_point_t *trace, int n)
+{
+    replay_result_t result = {};
+    reset_three_point_detector();
+
+    uint32_t base = sim_time_ms + 5000; // 与上一条轨迹隔开
+    for (int i = 0; i < n; i++)
+    {
+        sim_time_ms = base + trace[i].t_ms;
+
+        imu_euler_t euler;
+        euler.roll = trace[i].roll;
+        euler.pitch = trace[i].pitch;
+        euler.yaw = 0.0f;
+        euler.tilt = quat_from_roll_pitch(trace[i].roll, trace[i].pitch);
+        euler.gyro_x = trace[i].gyro[0];
+        euler.gyro_y = trace[i].gyro[1];
+        euler.gyro_z = trace[i].gyro[2];
+
+        simple_action_t action;
+        uint32_t execution_time;
+        note_duration_t note_type;
+        note_event_t event = detect_three_point_predictive(&euler, &action, &execution_time, &note_type);
+
+        switch (event)
+        {
+        case NOTE_EVENT_ONSET:
+            result.onsets++;
+            result.onset_ms = trace[i].t_ms;
+            break;
+        case NOTE_EVENT_CONFIRM:
+            result.confirms++;
+            result.note_ms = trace[i].t_ms;
+            break;
+        case NOTE_EVENT_TRIGGER:
+            result.triggers++;
+            result.note_ms = trace[i].t_ms;
+            break;
+        case NOTE_EVENT_CANCEL:
+            result.cancels++;
+            result.cancel_ms = trace[i].t_ms;
+            break;
+        default:
+            break;
+        }
+    }
+    return result;
+}
+
+// 完整的向下倾斜: 每条轨迹必须恰好发出一个音, 不能取消
+static void test_complete_gestures(void)
+{
+    static const uint32_t durations[] = {250, 400, 600};
+    static const uint32_t steps[] = {50, 20, 10, 2};
+    static trace_point_t trace[TRACE_MAX];
+
+    int total = 0, predicted = 0;
+    uint32_t saved_sum = 0;
+
+    for (uint32_t step : steps)
+    {
+        for (uint32_t d : durations)
+        {
+            const keyframe_t keys[] = {{0, 0.0f, 0.0f}, {200, 0.0f, 0.0f}, {200 + d, -55.0f, 0.0f}, {200 + d + 300, -55.0f, 0.0f}};
+            int n = build_trace(keys, 4, step, 0.3f, trace);
+            replay_result_t r = replay(trace, n);
+
+            CHECK(r.confirms + r.triggers == 1);
+            CHECK(r.cancels == 0);
+            CHECK(r.onsets == r.confirms);
+
+            total++;
+            if (r.confirms == 1)
+            {
+                predicted++;
+                saved_sum += r.note_ms - r.onset_ms;
+            }
+            printf("[完整] 步长%ums 用时%ums: %s, 节省%ums\n", step, d,
+                   r.confirms ? "提前起音" : "第3点触发", r.confirms ? r.note_ms - r.onset_ms : 0);
+        }
+    }
+
+    printf("完整动作: %d条, 提前起音%d条, 平均节省%ums\n", total, predicted,
+           predicted > 0 ? saved_sum / predicted : 0);
+    CHECK(predicted * 10 >= total * 8);
+    CHECK(predicted > 0 && saved_sum / predicted >= 30);
+}
+
+// 接近第3点后折返、侧向偏离或只回摆几度后停住: 不能发出确认的音; 提前起音必须在折返后很快取消.
+// 回摆停在 -19°: 取消时姿态落在向上倾斜第1、2点的重叠区, 回摆本身不能被识别成向上倾斜
+static void test_aborted_gestures(void)
+{
+    static const float turn_rolls[] = {-27.0f, -28.5f, -29.5f};
+    static const uint32_t steps[] = {50, 20, 10, 2};
+    static trace_point_t trace[TRACE_MAX];
+
+    static const char *const kinds[] = {"折返", "侧偏", "回摆"};
+
+    int total = 0, onsets = 0, cancels = 0;
+    uint32_t cancel_latency_max = 0;
+
+    for (int kind = 0; kind < 3; kind++)
+    {
+        for (uint32_t step : steps)
+        {
+            for (float turn : turn_rolls)
+            {
+                const uint32_t turn_ms = 200 + 300;
+                keyframe_t keys[] = {{0, 0.0f, 0.0f}, {200, 0.0f, 0.0f}, {turn_ms, turn, 0.0f}, {turn_ms + 300, 0.0f, 0.0f}, {turn_ms + 600, 0.0f, 0.0f}};
+                if (kind == 1)
+                {
+                    keys[3].roll = turn;
+                    keys[3].pitch = 45.0f;
+                    keys[4].roll = turn;
+                    keys[4].pitch = 45.0f;
+                }
+                else if (kind == 2)
+                {
+                    keys[3] = {turn_ms + 150, -19.0f, 0.0f};
+                    keys[4].roll = -19.0f;
+                }
+
+                int n = build_trace(keys, 5, step, 0.3f, trace);
+                replay_result_t r = replay(trace, n);
+
+                CHECK(r.confirms == 0);
+                CHECK(r.triggers == 0);
+                CHECK(r.cancels == r.onsets);
+
+                total++;
+                onsets += r.onsets;
+                cancels += r.cancels;
+                if (r.cancels > 0)
+                {
+                    uint32_t latency = r.cancel_ms > turn_ms ? r.cancel_ms - turn_ms : 0;
+                    // 修正前要等第2点后1秒超时才取消
+                    CHECK(latency <= 150);
+                    cancel_latency_max = latency > cancel_latency_max ? latency : cancel_latency_max;
+                }
+                printf("[%s] 步长%ums 折返%.1f°: 提前起音%d 取消%d\n", kinds[kind],
+                       step, turn, r.onsets, r.cancels);
+            }
+        }
+    }
+
+    printf("未完成动作: %d条, 误提前起音%d次, 全部取消%s, 最大取消延迟%ums\n", total, onsets,
+           cancels == onsets ? "是" : "否", cancel_latency_max);
+}
+
+// 按生产采样率 (400Hz FIFO 约2.5ms一个样本, 取2ms) 回放一组混合动作: 完整动作不同速度,
+// 折返点均匀分布在第2点到第3点之间, 完整与折返各6条; 检查提前起音的准确率、覆盖率和平均节省
+static void test_prediction_accuracy(void)
+{
+    static const uint32_t durations[] = {250, 300, 400, 500, 600, 800};
+    static const float turn_rolls[] = {-8.0f, -12.0f, -16.0f, -20.0f, -24.0f, -28.0f};
+    static trace_point_t trace[TRACE_MAX];
+
+    int complete = 0, predicted = 0, onsets = 0, confirmed = 0;
+    uint32_t saved_sum = 0;
+
+    for (uint32_t d : durations)
+    {
+        const keyframe_t keys[] = {{0, 0.0f, 0.0f}, {200, 0.0f, 0.0f}, {200 + d, -55.0f, 0.0f}, {200 + d + 300, -55.0f, 0.0f}};
+        int n = build_trace(keys, 4, 2, 0.3f, trace);
+        replay_result_t r = replay(trace, n);
+
+        complete++;
+        onsets += r.onsets;
+        if (r.confirms == 1)
+        {
+            predicted++;
+            confirmed++;
+            saved_sum += r.note_ms - r.onset_ms;
+        }
+    }
+
+    for (float turn : turn_rolls)
+    {
+        const keyframe_t keys[] = {{0, 0.0f, 0.0f}, {200, 0.0f, 0.0f}, {500, turn, 0.0f}, {800, 0.0f, 0.0f}, {1100, 0.0f, 0.0f}};
+        int n = build_trace(keys, 5, 2, 0.3f, trace);
+        replay_result_t r = replay(trace, n);
+
+        CHECK(r.confirms == 0 && r.triggers == 0);
+        onsets += r.onsets;
+    }
+
+    float accuracy = onsets > 0 ? (float)confirmed / onsets : 0.0f;
+    float coverage = (float)predicted / complete;
+    uint32_t saved_avg = predicted > 0 ? saved_sum / predicted : 0;
+    printf("准确率(2ms步长): 提前起音%d次 确认%d次 准确率%.0f%% 覆盖%.0f%% 平均节省%ums\n",
+           onsets, confirmed, 100.0f * accuracy, 100.0f * coverage, saved_avg);
+
+    CHECK(accuracy >= 0.8f);
+    CHECK(coverage >= 0.9f);
+    CHECK(saved_avg >= 30);
+}
+
+// 每个模板相邻两点必须分得开: 第1点的中心不能匹配第2点, 第2点的中心不能匹配第3点
+static void test_template_separation(void)
+{
+    for (int a = 0; a < (int)ACTION_NONE; a++)
+    {
+        quat_point_t points[3];
+        bool found = true;
+        for (int j = 0; j < 3; j++)
+        {
+            found = found && three_point_get_orientation((simple_action_t)a, j, &points[j]);
+        }
+        if (!found)
+        {
+            continue;
+        }
+
+        for (int j = 0; j < 2; j++)
+        {
+            float dist = quat_geodesic_deg(&points[j].q, &points[j + 1].q);
+            float tol = 2.0f * acosf(points[j + 1].cos_half_tol) * 57.29578f;
+            CHECK(!quat_point_matches(&points[j].q, &points[j + 1]));
+            printf("[模板] %s 第%d点->第%d点: 测地距离%.1f° 容差%.1f°\n",
+                   get_action_name((simple_action_t)a), j + 1, j + 2, dist, tol);
+        }
+    }
+}
+
+// 回放录制的轨迹
+static int replay_file(const char *path)
+{
+    static trace_point_t trace[TRACE_MAX];
+
+    FILE *f = fopen(path, "r");
+    if (f == NULL)
+    {
+        printf("无法打开 %s\n", path);
+        return 1;
+    }
+
+    int n = 0;
+    char line[128];
+    while (n < TRACE_MAX && fgets(line, sizeof(line), f) != NULL)
+    {
+        unsigned t;
+        float roll, pitch, gx, gy, gz;
+        int fields = sscanf(line, "%u,%f,%f,%f,%f,%f", &t, &roll, &pitch, &gx, &gy, &gz);
+        if (fields < 3)
+        {
+            continue;
+        }
+
+        trace[n].t_ms = t;
+        trace[n].roll = roll;
+        trace[n].pitch = pitch;
+        if (fields == 6)
+        {
+            trace[n].gyro[0] = gx;
+            trace[n].gyro[1] = gy;
+            trace[n].gyro[2] = gz;
+        }
+        else if (n > 0 && t > trace[n - 1].t_ms)
+        {
+            body_rate(trace[n - 1].roll, trace[n - 1].pitch, roll, pitch, (float)(t - trace[n - 1].t_ms), trace[n].gyro);
+        }
+        else
+        {
+            trace[n].gyro[0] = trace[n].gyro[1] = trace[n].gyro[2] = 0.0f;
+        }
+        n++;
+    }
+    fclose(f);
+
+    replay_result_t r = replay(trace, n);
+    printf("%s: %d个样本, 提前起音%d 确认%d 取消%d 第3点触发%d\n", path, n,
+           r.onsets, r.confirms, r.cancels, r.triggers);
+    print_prediction_stats();
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    three_point_set_clock(sim_clock);
+
+    if (argc > 1)
+    {
+        return replay_file(argv[1]);
+    }
+
+    test_template_separation();
+    test_complete_gestures();
+    test_aborted_gestures();
+    test_prediction_accuracy();
+    print_prediction_stats();
+    return test_result("test_three_point");
+}
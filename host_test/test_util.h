@@ -0,0 +1,38 @@
+#ifndef TEST_UTIL_H
+#define TEST_UTIL_H
+
+#include <stdio.h>
+#include <math.h>
+
+// 最小测试工具: 失败时打印位置并计数, main 返回失败数
+static int test_failures = 0;
+
+#define CHECK(cond)                                                   \
+    do                                                                \
+    {                                                                 \
+        if (!(cond))                                                  \
+        {                                                             \
+            printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond);    \
+            test_failures++;                                          \
+        }                                                             \
+    } while (0)
+
+#define CHECK_NEAR(a, b, tol)                                                          \
+    do                                                                                 \
+    {                                                                                  \
+        double va_ = (a), vb_ = (b);                                                   \
+        if (!(fabs(va_ - vb_) <= (tol)))                                               \
+        {                                                                              \
+            printf("FAIL %s:%d: %s = %g, %s = %g (容差 %g)\n", __FILE__, __LINE__, #a, \
+                   va_, #b, vb_, (double)(tol));                                       \
+            test_failures++;                                                           \
+        }                                                                              \
+    } while (0)
+
+static int test_result(const char *name)
+{
+    printf("%s: %s (%d 处失败)\n", name, test_failures == 0 ? "通过" : "失败", test_failures);
+    return test_failures == 0 ? 0 : 1;
+}
+
+#endif // TEST_UTIL_H
\ No newline at end of file
@@ -0,0 +1,586 @@
+#include "bodynet.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#ifdef BODYNET_PROFILE
+#include <chrono>
+#endif
+
+// ============= 节点端 =============
+
+void bodynet_node_init(bodynet_node_t *node, uint8_t node_id, uint8_t hub_id, const bodynet_transport_t *transport)
+{
+    memset(node, 0, sizeof(*node));
+    node->node_id = node_id;
+    node->hub_id = hub_id;
+    node->transport = *transport;
+    node->flush_budget_us = BODYNET_FLUSH_BUDGET_US;
+}
+
+void bodynet_node_flush(bodynet_node_t *node)
+{
+    bodynet_batch_msg_t *batch = &node->batch;
+    if (batch->hdr.count == 0)
+    {
+        return;
+    }
+
+    batch->hdr.type = BODYNET_MSG_SAMPLES;
+    batch->hdr.src = node->node_id;
+    batch->hdr.dst = node->hub_id;
+    batch->hdr.seq = node->seq++;
+
+    size_t len = sizeof(bodynet_header_t) + batch->hdr.count * sizeof(bodynet_sample_t);
+    if (node->transport.send(node->transport.ctx, node->hub_id, batch, len) != 0)
+    {
+        node->send_failures++;
+    }
+    batch->hdr.count = 0;
+}
+
+void bodynet_node_push_sample(bodynet_node_t *node, int64_t now_us, const imu_data_t *data)
+{
+    bodynet_batch_msg_t *batch = &node->batch;
+    batch->samples[batch->hdr.count].t_us = now_us;
+    batch->samples[batch->hdr.count].data = *data;
+    batch->hdr.count++;
+
+    if (batch->hdr.count >= BODYNET_BATCH_MAX || now_us - batch->samples[0].t_us >= node->flush_budget_us)
+    {
+        bodynet_node_flush(node);
+    }
+}
+
+void bodynet_node_poll(bodynet_node_t *node, int64_t now_us)
+{
+    uint8_t buf[BODYNET_MAX_PACKET];
+    int64_t rx_us;
+    int len;
+
+    // 采样停止或变慢时, 已有样本不能无限等待凑批
+    if (node->batch.hdr.count > 0 && now_us - node->batch.samples[0].t_us >= node->flush_budget_us)
+    {
+        bodynet_node_flush(node);
+    }
+
+    while ((len = node->transport.recv(node->transport.ctx, buf, sizeof(buf), &rx_us)) > 0)
+    {
+        const bodynet_header_t *hdr = (const bodynet_header_t *)buf;
+        if ((size_t)len < sizeof(bodynet_sync_msg_t) || hdr->type != BODYNET_MSG_SYNC_REQ)
+        {
+            continue;
+        }
+        if (hdr->dst != node->node_id && hdr->dst != BODYNET_BROADCAST)
+        {
+            continue;
+        }
+
+        bodynet_sync_msg_t resp;
+        memcpy(&resp, buf, sizeof(resp));
+        resp.hdr.type = BODYNET_MSG_SYNC_RESP;
+        resp.hdr.src = node->node_id;
+        resp.hdr.dst = hdr->src;
+        resp.t2 = rx_us;
+        resp.t3 = now_us;
+        if (node->transport.send(node->transport.ctx, hdr->src, &resp, sizeof(resp)) != 0)
+        {
+            node->send_failures++;
+        }
+    }
+}
+
+// ============= 时钟估计 =============
+
+// 加入一次对时结果, 用往返延迟较小的样本做线性回归得到偏移和漂移
+static void clock_update(bodynet_clock_t *clock, int64_t t1, int64_t t2, int64_t t3, int64_t t4)
+{
+    int64_t offset = ((t2 - t1) + (t3 - t4)) / 2;
+    int64_t delay = (t4 - t1) - (t3 - t2);
+    if (delay < 0)
+    {
+        delay = 0;
+    }
+
+    if (!clock->synced)
+    {
+        clock->base_offset_us = offset;
+    }
+
+    clock->x_us[clock->head] = (t2 + t3) / 2;
+    clock->offset_us[clock->head] = (float)(offset - clock->base_offset_us);
+    clock->delay_us[clock->head] = (uint32_t)delay;
+    clock->head = (clock->head + 1) % BODYNET_SYNC_WINDOW;
+    if (clock->count < BODYNET_SYNC_WINDOW)
+    {
+        clock->count++;
+    }
+
+    // 往返延迟大的样本偏移误差大, 丢弃
+    uint32_t min_delay = UINT32_MAX;
+    for (int i = 0; i < clock->count; i++)
+    {
+        if (clock->delay_us[i] < min_delay)
+        {
+            min_delay = clock->delay_us[i];
+        }
+    }
+    uint32_t max_delay = min_delay * 2 + 500;
+
+    int n = 0;
+    int64_t x_ref = 0;
+    for (int i = 0; i < clock->count; i++)
+    {
+        if (clock->delay_us[i] <= max_delay)
+        {
+            if (n == 0)
+            {
+                x_ref = clock->x_us[i];
+            }
+            n++;
+        }
+    }
+
+    double sx = 0, sy = 0, sxx = 0, sxy = 0;
+    for (int i = 0; i < clock->count; i++)
+    {
+        if (clock->delay_us[i] > max_delay)
+        {
+            continue;
+        }
+        double x = (double)(clock->x_us[i] - x_ref);
+        double y = clock->offset_us[i];
+        sx += x;
+        sy += y;
+        sxx += x * x;
+        sxy += x * y;
+    }
+
+    double mean_x = sx / n;
+    double mean_y = sy / n;
+    double var_x = sxx / n - mean_x * mean_x;
+
+    clock->ref_us = x_ref + (int64_t)mean_x;
+    clock->offset_at_ref_us = (float)mean_y;
+    clock->drift = var_x > 1.0 ? (float)((sxy / n - mean_x * mean_y) / var_x) : 0.0f;
+    clock->synced = true;
+}
+
+int64_t bodynet_clock_to_hub(const bodynet_clock_t *clock, int64_t node_us)
+{
+    float offset = clock->offset_at_ref_us + clock->drift * (float)(node_us - clock->ref_us);
+    return node_us - clock->base_offset_us - (int64_t)offset;
+}
+
+// ============= 汇聚端 =============
+
+void bodynet_hub_init(bodynet_hub_t *hub, uint8_t hub_id, uint8_t node_mask, uint32_t frame_period_us, const bodynet_transport_t *transport)
+{
+    memset(hub, 0, sizeof(*hub));
+    hub->hub_id = hub_id;
+    hub->node_mask = node_mask;
+    hub->transport = *transport;
+    hub->frame_period_us = frame_period_us;
+    // 节点最迟每个等待时间发送一次, 汇聚端每个帧周期左右处理一次, 取两者较大值的若干倍
+    uint32_t rx_interval_us = frame_period_us > BODYNET_FLUSH_BUDGET_US ? frame_period_us : BODYNET_FLUSH_BUDGET_US;
+    hub->node_timeout_us = BODYNET_TIMEOUT_PERIODS * rx_interval_us;
+    hub->sync_period_us = 200000;
+    hub->sync_next_node = 0;
+
+    // 本地节点与汇聚端同一时钟
+    hub->peers[hub_id].clock.synced = true;
+}
+
+static void peer_push(bodynet_hub_t *hub, bodynet_peer_t *peer, int64_t t_us, const imu_data_t *data)
+{
+    if (peer->count == BODYNET_RING_LEN)
+    {
+        // 缓冲满, 丢弃最旧样本
+        peer->count--;
+        hub->stats.samples_dropped++;
+    }
+
+    peer->ring[peer->head].t_us = t_us;
+    peer->ring[peer->head].data = *data;
+    peer->head = (peer->head + 1) % BODYNET_RING_LEN;
+    peer->count++;
+}
+
+void bodynet_hub_push_local(bodynet_hub_t *hub, int64_t now_us, const imu_data_t *data)
+{
+    bodynet_peer_t *peer = &hub->peers[hub->hub_id];
+    hub->stats.samples_in++;
+    peer_push(hub, peer, now_us, data);
+    peer->last_rx_us = now_us;
+    peer->active = true;
+}
+
+static void hub_handle_samples(bodynet_hub_t *hub, const uint8_t *buf, int len, int64_t now_us)
+{
+    bodynet_batch_msg_t batch;
+    memcpy(&batch, buf, len < (int)sizeof(batch) ? len : sizeof(batch));
+
+    int count = batch.hdr.count;
+    if (count > BODYNET_BATCH_MAX || sizeof(bodynet_header_t) + count * sizeof(bodynet_sample_t) > (size_t)len)
+    {
+        return;
+    }
+
+    bodynet_peer_t *peer = &hub->peers[batch.hdr.src];
+    hub->stats.samples_in += count;
+
+    // 未对时的节点无法对齐, 丢弃
+    if (!peer->clock.synced)
+    {
+        hub->stats.samples_dropped += count;
+        return;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        imu_data_t data = batch.samples[i].data; // 打包结构体成员可能未对齐, 先拷贝
+        peer_push(hub, peer, bodynet_clock_to_hub(&peer->clock, batch.samples[i].t_us), &data);
+    }
+    peer->last_rx_us = now_us;
+    peer->active = true;
+}
+
+static void hub_send_sync(bodynet_hub_t *hub, int64_t now_us)
+{
+    // 轮流向各远端节点发送对时请求
+    for (int n = 0; n < BODYNET_MAX_NODES; n++)
+    {
+        uint8_t id = hub->sync_next_node;
+        hub->sync_next_node = (hub->sync_next_node + 1) % BODYNET_MAX_NODES;
+
+        if (id == hub->hub_id || !(hub->node_mask & (1 << id)))
+        {
+            continue;
+        }
+
+        bodynet_sync_msg_t req;
+        memset(&req, 0, sizeof(req));
+        req.hdr.type = BODYNET_MSG_SYNC_REQ;
+        req.hdr.src = hub->hub_id;
+        req.hdr.dst = id;
+        req.hdr.seq = ++hub->peers[id].sync_seq;
+        req.t1 = now_us;
+        if (hub->transport.send(hub->transport.ctx, id, &req, sizeof(req)) != 0)
+        {
+            hub->stats.send_failures++;
+        }
+        break;
+    }
+    hub->last_sync_us = now_us;
+}
+
+void bodynet_hub_poll(bodynet_hub_t *hub, int64_t now_us)
+{
+    uint8_t buf[BODYNET_MAX_PACKET];
+    int64_t rx_us;
+    int len;
+
+    while ((len = hub->transport.recv(hub->transport.ctx, buf, sizeof(buf), &rx_us)) > 0)
+    {
+        const bodynet_header_t *hdr = (const bodynet_header_t *)buf;
+        if ((size_t)len < sizeof(bodynet_header_t) || hdr->src >= BODYNET_MAX_NODES || hdr->src == hub->hub_id)
+        {
+            continue;
+        }
+        if (hdr->dst != hub->hub_id && hdr->dst != BODYNET_BROADCAST)
+        {
+            continue;
+        }
+
+        if (hdr->type == BODYNET_MSG_SAMPLES)
+        {
+            hub_handle_samples(hub, buf, len, now_us);
+        }
+        else if (hdr->type == BODYNET_MSG_SYNC_RESP && (size_t)len >= sizeof(bodynet_sync_msg_t))
+        {
+            bodynet_sync_msg_t resp;
+            memcpy(&resp, buf, sizeof(resp));
+
+            bodynet_peer_t *peer = &hub->peers[resp.hdr.src];
+            if (resp.hdr.seq == peer->sync_seq)
+            {
+                clock_update(&peer->clock, resp.t1, resp.t2, resp.t3, rx_us);
+                hub->stats.syncs++;
+            }
+        }
+    }
+
+    if (now_us - hub->last_sync_us >= hub->sync_period_us)
+    {
+        hub_send_sync(hub, now_us);
+    }
+}
+
+// 节点在帧时间 t 处的线性插值, 返回最近实际样本的时间
+static int64_t peer_sample_at(bodynet_peer_t *peer, int64_t t, imu_data_t *out)
+{
+    int oldest = (peer->head + BODYNET_RING_LEN - peer->count) % BODYNET_RING_LEN;
+
+    // 丢弃帧时间之前不再需要的样本, 保留 t 之前最近的一个
+    while (peer->count > 1 && peer->ring[(oldest + 1) % BODYNET_RING_LEN].t_us <= t)
+    {
+        oldest = (oldest + 1) % BODYNET_RING_LEN;
+        peer->count--;
+    }
+
+    const bodynet_timed_sample_t *a = &peer->ring[oldest];
+    if (peer->count == 1 || a->t_us >= t)
+    {
+        *out = a->data;
+        return a->t_us;
+    }
+
+    const bodynet_timed_sample_t *b = &peer->ring[(oldest + 1) % BODYNET_RING_LEN];
+    float w = (float)(t - a->t_us) / (float)(b->t_us - a->t_us);
+
+    const float *pa = &a->data.accel_x;
+    const float *pb = &b->data.accel_x;
+    float *po = &out->accel_x;
+    for (int i = 0; i < 9; i++)
+    {
+        po[i] = pa[i] + (pb[i] - pa[i]) * w;
+    }
+
+    return (t - a->t_us) < (b->t_us - t) ? a->t_us : b->t_us;
+}
+
+static int64_t peer_newest(const bodynet_peer_t *peer)
+{
+    return peer->ring[(peer->head + BODYNET_RING_LEN - 1) % BODYNET_RING_LEN].t_us;
+}
+
+static int64_t peer_oldest(const bodynet_peer_t *peer)
+{
+    return peer->ring[(peer->head + BODYNET_RING_LEN - peer->count) % BODYNET_RING_LEN].t_us;
+}
+
+bool bodynet_hub_pop_frame(bodynet_hub_t *hub, int64_t now_us, bodynet_frame_t *frame)
+{
+#ifdef BODYNET_PROFILE
+    auto begin = std::chrono::steady_clock::now();
+#endif
+
+    // 在线节点: 已对时、有数据且未超时
+    uint8_t online = 0;
+    for (int i = 0; i < BODYNET_MAX_NODES; i++)
+    {
+        const bodynet_peer_t *peer = &hub->peers[i];
+        if ((hub->node_mask & (1 << i)) && peer->active && peer->count > 0 &&
+            now_us - peer->last_rx_us <= hub->node_timeout_us)
+        {
+            online |= 1 << i;
+        }
+    }
+    if (online == 0)
+    {
+        return false;
+    }
+
+    // 第一帧从所有节点都有数据的时刻开始
+    if (hub->next_frame_us == 0)
+    {
+        for (int i = 0; i < BODYNET_MAX_NODES; i++)
+        {
+            if ((online & (1 << i)) && peer_oldest(&hub->peers[i]) > hub->next_frame_us)
+            {
+                hub->next_frame_us = peer_oldest(&hub->peers[i]);
+            }
+        }
+    }
+
+    // 所有在线节点都越过帧时间才能输出
+    for (int i = 0; i < BODYNET_MAX_NODES; i++)
+    {
+        if ((online & (1 << i)) && peer_newest(&hub->peers[i]) < hub->next_frame_us)
+        {
+            return false;
+        }
+    }
+
+    int64_t t = hub->next_frame_us;
+    int64_t nearest_min = INT64_MAX;
+    int64_t nearest_max = INT64_MIN;
+
+    memset(frame, 0, sizeof(*frame));
+    frame->t_us = t;
+    frame->valid_mask = online;
+
+    for (int i = 0; i < BODYNET_MAX_NODES; i++)
+    {
+        if (!(online & (1 << i)))
+        {
+            continue;
+        }
+        int64_t nearest = peer_sample_at(&hub->peers[i], t, &frame->limbs[i]);
+        nearest_min = nearest < nearest_min ? nearest : nearest_min;
+        nearest_max = nearest > nearest_max ? nearest : nearest_max;
+    }
+
+    hub->next_frame_us += hub->frame_period_us;
+
+    // 落后太多时追上, 避免输出大量过期帧
+    if (now_us - hub->next_frame_us > (int64_t)hub->frame_period_us * 10)
+    {
+        hub->next_frame_us = now_us;
+    }
+
+    bodynet_stats_t *stats = &hub->stats;
+    int64_t skew = nearest_max - nearest_min;
+    int64_t latency = now_us - t;
+    stats->frames_out++;
+    stats->skew_sum_us += skew;
+    stats->skew_max_us = skew > stats->skew_max_us ? skew : stats->skew_max_us;
+    stats->latency_sum_us += latency;
+    stats->latency_max_us = latency > stats->latency_max_us ? latency : stats->latency_max_us;
+#ifdef BODYNET_PROFILE
+    stats->merge_time_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - begin).count();
+#endif
+
+    return true;
+}
+
+void bodynet_hub_print_stats(const bodynet_hub_t *hub)
+{
+    const bodynet_stats_t *stats = &hub->stats;
+
+    printf("多节点统计: 样本%lu 丢弃%lu 帧%lu 对时%lu 发送失败%lu\n",
+           (unsigned long)stats->samples_in, (unsigned long)stats->samples_dropped,
+           (unsigned long)stats->frames_out, (unsigned long)stats->syncs, (unsigned long)stats->send_failures);
+
+    if (stats->frames_out > 0)
+    {
+        printf("肢体间偏差: 平均%lldus 最大%lldus\n",
+               (long long)(stats->skew_sum_us / stats->frames_out), (long long)stats->skew_max_us);
+        printf("端到端延迟: 平均%lldus 最大%lldus\n",
+               (long long)(stats->latency_sum_us / stats->frames_out), (long long)stats->latency_max_us);
+#ifdef BODYNET_PROFILE
+        printf("合并耗时: 平均%.0fns/帧\n", (double)stats->merge_time_ns / stats->frames_out);
+#endif
+    }
+
+    for (int i = 0; i < BODYNET_MAX_NODES; i++)
+    {
+        const bodynet_clock_t *clock = &hub->peers[i].clock;
+        if ((hub->node_mask & (1 << i)) && i != hub->hub_id && clock->synced)
+        {
+            printf("节点%d: 偏移%lldus 漂移%.2fppm\n", i,
+                   (long long)(clock->base_offset_us + (int64_t)clock->offset_at_ref_us), clock->drift * 1e6f);
+        }
+    }
+}
+
+// ============= 多肢体模板 =============
+
+bool bodynet_pose_matches(const bodynet_frame_t *frame, const bodynet_pose_t *pose)
+{
+    for (int i = 0; i < BODYNET_MAX_NODES; i++)
+    {
+        if (!(pose->limb_mask & (1 << i)))
+        {
+            continue;
+        }
+        if (!(frame->valid_mask & (1 << i)))
+        {
+            return false;
+        }
+
+        const imu_data_t *d = &frame->limbs[i];
+        float n = sqrtf(d->accel_x * d->accel_x + d->accel_y * d->accel_y + d->accel_z * d->accel_z);
+        if (n < 0.01f)
+        {
+            return false;
+        }
+
+        quat_t tilt = quat_from_gravity(d->accel_x / n, d->accel_y / n, d->accel_z / n);
+        if (!quat_point_matches(&tilt, &pose->limb[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ============= 进程内回环传输 =============
+
+void bodynet_loopback_init(bodynet_loopback_bus_t *bus, bodynet_loopback_clock_t clock)
+{
+    memset(bus, 0, sizeof(*bus));
+    bus->clock = clock;
+}
+
+static int loopback_deliver(bodynet_loopback_bus_t *bus, uint8_t dst, const void *buf, size_t len)
+{
+    bodynet_loopback_mailbox_t *box = &bus->mailbox[dst];
+    if (box->count == BODYNET_LOOPBACK_DEPTH)
+    {
+        box->dropped++;
+        return -1;
+    }
+
+    int slot = (box->head + box->count) % BODYNET_LOOPBACK_DEPTH;
+    memcpy(box->buf[slot], buf, len);
+    box->len[slot] = (uint8_t)len;
+    box->rx_us[slot] = bus->clock != NULL ? bus->clock(dst) : 0;
+    box->count++;
+    return 0;
+}
+
+static int loopback_send(void *ctx, uint8_t dst, const void *buf, size_t len)
+{
+    bodynet_loopback_port_t *port = (bodynet_loopback_port_t *)ctx;
+    if (len > BODYNET_MAX_PACKET)
+    {
+        return -1;
+    }
+
+    if (dst == BODYNET_BROADCAST)
+    {
+        for (int i = 0; i < BODYNET_MAX_NODES; i++)
+        {
+            if (i != port->node_id)
+            {
+                loopback_deliver(port->bus, i, buf, len);
+            }
+        }
+        return 0;
+    }
+    if (dst >= BODYNET_MAX_NODES)
+    {
+        return -1;
+    }
+    return loopback_deliver(port->bus, dst, buf, len);
+}
+
+static int loopback_recv(void *ctx, void *buf, size_t max_len, int64_t *rx_us)
+{
+    bodynet_loopback_port_t *port = (bodynet_loopback_port_t *)ctx;
+    bodynet_loopback_mailbox_t *box = &port->bus->mailbox[port->node_id];
+    if (box->count == 0)
+    {
+        return 0;
+    }
+
+    size_t len = box->len[box->head];
+    if (len > max_len)
+    {
+        len = max_len;
+    }
+    memcpy(buf, box->buf[box->head], len);
+    *rx_us = box->rx_us[box->head];
+    box->head = (box->head + 1) % BODYNET_LOOPBACK_DEPTH;
+    box->count--;
+    return (int)len;
+}
+
+bodynet_transport_t bodynet_loopback_transport(bodynet_loopback_port_t *port, bodynet_loopback_bus_t *bus, uint8_t node_id)
+{
+    port->bus = bus;
+    port->node_id = node_id;
+
+    bodynet_transport_t transport = {loopback_send, loopback_recv, port};
+    return transport;
+}
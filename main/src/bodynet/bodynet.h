@@ -0,0 +1,233 @@
+#ifndef BODYNET_H
+#define BODYNET_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "imu/imu.h"
+#include "quat/quat.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define BODYNET_MAX_NODES 4       // 最多节点数 (双手腕 + 双脚踝)
+#define BODYNET_BATCH_MAX 5       // 每包最多样本数 (ESP-NOW 单包 ≤ 250 字节)
+#define BODYNET_RING_LEN 64       // 汇聚端每个节点的样本缓冲
+#define BODYNET_SYNC_WINDOW 8     // 时钟估计使用的最近同步次数
+#define BODYNET_BROADCAST 0xFF    // 广播地址
+#define BODYNET_MAX_PACKET 250    // 传输层最大包长
+#define BODYNET_FLUSH_BUDGET_US 20000 // 节点未满的批最长等待时间
+#define BODYNET_TIMEOUT_PERIODS 4     // 节点超时 = 该倍数 × max(发送间隔上限, 帧周期)
+
+    // ============= 节点协议 =============
+
+    typedef enum
+    {
+        BODYNET_MSG_SAMPLES = 1, // 节点 -> 汇聚端: 带时间戳的样本批
+        BODYNET_MSG_SYNC_REQ,    // 汇聚端 -> 节点: 对时请求
+        BODYNET_MSG_SYNC_RESP    // 节点 -> 汇聚端: 对时应答
+    } bodynet_msg_type_t;
+
+    typedef struct __attribute__((packed))
+    {
+        uint8_t type;
+        uint8_t src;
+        uint8_t dst;
+        uint8_t count; // 样本数 (仅 SAMPLES)
+        uint16_t seq;
+    } bodynet_header_t;
+
+    typedef struct __attribute__((packed))
+    {
+        int64_t t_us; // 节点本地时间
+        imu_data_t data;
+    } bodynet_sample_t;
+
+    typedef struct __attribute__((packed))
+    {
+        bodynet_header_t hdr;
+        bodynet_sample_t samples[BODYNET_BATCH_MAX];
+    } bodynet_batch_msg_t;
+
+    // NTP式四时间戳对时: t1 汇聚端发送, t2 节点接收, t3 节点发送, t4 汇聚端接收
+    typedef struct __attribute__((packed))
+    {
+        bodynet_header_t hdr;
+        int64_t t1;
+        int64_t t2;
+        int64_t t3;
+    } bodynet_sync_msg_t;
+
+    // ============= 传输层 =============
+
+    // 与具体传输无关的收发接口, 均为非阻塞
+    // 对时用包到达时的本地时间, 而不是被轮询取出的时间, 否则主循环相位差会成为固定的偏移误差
+    typedef struct
+    {
+        int (*send)(void *ctx, uint8_t dst, const void *buf, size_t len);   // 成功返回0
+        int (*recv)(void *ctx, void *buf, size_t max_len, int64_t *rx_us); // 返回包长, 无数据返回0; rx_us 为到达时的本地时间
+        void *ctx;
+    } bodynet_transport_t;
+
+    // 进程内回环传输, 用于在一台机器上模拟N个节点
+#define BODYNET_LOOPBACK_DEPTH 16
+
+    // 节点 node_id 的本地时间, 作为包到达时间 (仿真中可注入时钟偏移、漂移和传输延迟)
+    typedef int64_t (*bodynet_loopback_clock_t)(uint8_t node_id);
+
+    typedef struct
+    {
+        uint8_t len[BODYNET_LOOPBACK_DEPTH];
+        int64_t rx_us[BODYNET_LOOPBACK_DEPTH];
+        uint8_t buf[BODYNET_LOOPBACK_DEPTH][BODYNET_MAX_PACKET];
+        uint8_t head;
+        uint8_t count;
+        uint32_t dropped;
+    } bodynet_loopback_mailbox_t;
+
+    typedef struct
+    {
+        bodynet_loopback_mailbox_t mailbox[BODYNET_MAX_NODES];
+        bodynet_loopback_clock_t clock; // 为 NULL 时到达时间为0
+    } bodynet_loopback_bus_t;
+
+    typedef struct
+    {
+        bodynet_loopback_bus_t *bus;
+        uint8_t node_id;
+    } bodynet_loopback_port_t;
+
+    void bodynet_loopback_init(bodynet_loopback_bus_t *bus, bodynet_loopback_clock_t clock);
+    bodynet_transport_t bodynet_loopback_transport(bodynet_loopback_port_t *port, bodynet_loopback_bus_t *bus, uint8_t node_id);
+
+    // ============= 节点端 =============
+
+    typedef struct
+    {
+        uint8_t node_id;
+        uint8_t hub_id;
+        bodynet_transport_t transport;
+        bodynet_batch_msg_t batch;
+        uint16_t seq;
+        uint32_t flush_budget_us; // 批中第一个样本最多等待这么久就发送
+        uint32_t send_failures;   // 传输层拒收的批和对时应答 (批随之丢弃)
+    } bodynet_node_t;
+
+    void bodynet_node_init(bodynet_node_t *node, uint8_t node_id, uint8_t hub_id, const bodynet_transport_t *transport);
+
+    // 采集一个样本 (按IMU采样率调用), 凑满一批或超过等待时间后发送
+    void bodynet_node_push_sample(bodynet_node_t *node, int64_t now_us, const imu_data_t *data);
+
+    // 立即发送未满的批
+    void bodynet_node_flush(bodynet_node_t *node);
+
+    // 处理收到的包 (应答对时请求, t2 为请求到达时间、t3 为应答发送时间), 发送超过等待时间的未满批
+    void bodynet_node_poll(bodynet_node_t *node, int64_t now_us);
+
+    // ============= 汇聚端 =============
+
+    // 节点时钟估计: hub_time = node_time - (offset + drift * (node_time - ref))
+    typedef struct
+    {
+        int64_t x_us[BODYNET_SYNC_WINDOW];     // 节点时间
+        float offset_us[BODYNET_SYNC_WINDOW];  // 节点 - 汇聚端, 相对 base_offset
+        uint32_t delay_us[BODYNET_SYNC_WINDOW]; // 往返延迟
+        uint8_t head;
+        uint8_t count;
+
+        int64_t base_offset_us; // 第一次对时的偏移, 其余偏移相对它保存以保持float精度
+        int64_t ref_us;         // 回归参考点(节点时间)
+        float offset_at_ref_us; // 参考点处的偏移(相对 base_offset)
+        float drift;            // 频率偏差 (无量纲, 1e-6 = 1ppm)
+        bool synced;
+    } bodynet_clock_t;
+
+    typedef struct
+    {
+        int64_t t_us; // 已换算到汇聚端时间
+        imu_data_t data;
+    } bodynet_timed_sample_t;
+
+    typedef struct
+    {
+        bodynet_clock_t clock;
+        bodynet_timed_sample_t ring[BODYNET_RING_LEN];
+        uint8_t head;
+        uint8_t count;
+        int64_t last_rx_us; // 最近一次收到样本 (汇聚端时间)
+        bool active;
+        uint16_t sync_seq;
+    } bodynet_peer_t;
+
+    // 时间对齐后的多肢体帧
+    typedef struct
+    {
+        int64_t t_us;
+        uint8_t valid_mask; // 第 i 位表示节点 i 有数据
+        imu_data_t limbs[BODYNET_MAX_NODES];
+    } bodynet_frame_t;
+
+    typedef struct
+    {
+        uint32_t samples_in;      // 收到的样本
+        uint32_t samples_dropped; // 未对时或缓冲溢出丢弃的样本
+        uint32_t frames_out;      // 输出帧数
+        uint32_t syncs;           // 完成的对时次数
+        uint32_t send_failures;   // 传输层拒收的对时请求
+        int64_t skew_max_us;      // 帧内各肢体最近样本时间的最大差
+        int64_t skew_sum_us;
+        int64_t latency_max_us;   // 端到端延迟: 输出时刻 - 帧时间
+        int64_t latency_sum_us;
+        int64_t merge_time_ns;    // 合并累计耗时, 只在定义 BODYNET_PROFILE 时采集, 否则每帧两次取时钟计入合并开销
+    } bodynet_stats_t;
+
+    typedef struct
+    {
+        uint8_t hub_id;
+        uint8_t node_mask; // 期望的节点 (含汇聚端本地节点)
+        bodynet_transport_t transport;
+        bodynet_peer_t peers[BODYNET_MAX_NODES];
+        uint32_t frame_period_us;
+        uint32_t node_timeout_us; // 由节点发送间隔上限和帧周期推出, 见 BODYNET_TIMEOUT_PERIODS
+        uint32_t sync_period_us;
+        int64_t next_frame_us;
+        int64_t last_sync_us;
+        uint8_t sync_next_node;
+        bodynet_stats_t stats;
+    } bodynet_hub_t;
+
+    void bodynet_hub_init(bodynet_hub_t *hub, uint8_t hub_id, uint8_t node_mask, uint32_t frame_period_us, const bodynet_transport_t *transport);
+
+    // 汇聚端本机传感器样本 (本地时钟即汇聚端时钟)
+    void bodynet_hub_push_local(bodynet_hub_t *hub, int64_t now_us, const imu_data_t *data);
+
+    // 接收样本和对时应答, 并周期性发送对时请求
+    void bodynet_hub_poll(bodynet_hub_t *hub, int64_t now_us);
+
+    // 所有在线节点都已越过下一帧时间时输出一帧
+    bool bodynet_hub_pop_frame(bodynet_hub_t *hub, int64_t now_us, bodynet_frame_t *frame);
+
+    // 节点时间换算到汇聚端时间
+    int64_t bodynet_clock_to_hub(const bodynet_clock_t *clock, int64_t node_us);
+
+    void bodynet_hub_print_stats(const bodynet_hub_t *hub);
+
+    // ============= 多肢体模板 =============
+
+    typedef struct
+    {
+        uint8_t limb_mask; // 参与匹配的节点
+        quat_point_t limb[BODYNET_MAX_NODES];
+        const char *name;
+    } bodynet_pose_t;
+
+    // 所有参与的肢体都在各自的姿态容差内
+    bool bodynet_pose_matches(const bodynet_frame_t *frame, const bodynet_pose_t *pose);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BODYNET_H
\ No newline at end of file
@@ -0,0 +1,177 @@
+#include "bodynet_espnow.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+#include "freertos/task.h"
+#include "esp_idf_version.h"
+#include "esp_wifi.h"
+#include "esp_now.h"
+#include "esp_netif.h"
+#include "esp_event.h"
+#include "nvs_flash.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "memstat/memstat.h"
+#include <string.h>
+
+static const char *TAG = "BODYNET";
+
+#define ESPNOW_QUEUE_LEN 16
+#define ESPNOW_TX_QUEUE_LEN 16
+#define ESPNOW_TX_STACK_SIZE 3072 // 字节
+#define ESPNOW_TX_PRIORITY 4      // 低于 imu_task
+
+typedef struct
+{
+    int64_t rx_us; // 到达时间, 在接收回调中记录
+    uint8_t len;
+    uint8_t buf[BODYNET_MAX_PACKET];
+} espnow_packet_t;
+
+static QueueHandle_t rx_queue = NULL;
+static StaticQueue_t rx_queue_buf;
+static uint8_t rx_queue_storage[ESPNOW_QUEUE_LEN * sizeof(espnow_packet_t)];
+static const uint8_t broadcast_mac[ESP_NOW_ETH_ALEN] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+// 发送队列和发送任务: esp_now_send 在默认的动态WiFi发送缓冲下会在调用任务中分配堆内存,
+// 放到单独的任务中执行, app_main 只拷贝入队, 不违反稳态零分配 (发送任务不登记稳态检查)
+static QueueHandle_t tx_queue = NULL;
+static StaticQueue_t tx_queue_buf;
+static uint8_t tx_queue_storage[ESPNOW_TX_QUEUE_LEN * sizeof(espnow_packet_t)];
+static StaticTask_t tx_task_buf;
+static StackType_t tx_task_stack[ESPNOW_TX_STACK_SIZE];
+static volatile uint32_t tx_failures = 0; // 入队失败或 esp_now_send 失败
+
+// 接收回调在WiFi任务中运行, 只记录到达时间并拷贝入队
+#if ESP_IDF_VERSION >= ESP_IDF_VERSION_VAL(5, 0, 0)
+static void espnow_recv_cb(const esp_now_recv_info_t *info, const uint8_t *data, int len)
+#else
+static void espnow_recv_cb(const uint8_t *mac, const uint8_t *data, int len)
+#endif
+{
+    if (len <= 0 || len > BODYNET_MAX_PACKET)
+    {
+        return;
+    }
+
+    espnow_packet_t packet;
+    packet.rx_us = esp_timer_get_time();
+    packet.len = (uint8_t)len;
+    memcpy(packet.buf, data, len);
+    xQueueSend(rx_queue, &packet, 0);
+}
+
+static void espnow_tx_task(void *parameter)
+{
+    espnow_packet_t packet;
+    while (1)
+    {
+        if (xQueueReceive(tx_queue, &packet, portMAX_DELAY) != pdTRUE)
+        {
+            continue;
+        }
+        // 统一广播, 接收端按包头 dst 过滤
+        if (esp_now_send(broadcast_mac, packet.buf, packet.len) != ESP_OK)
+        {
+            tx_failures++;
+        }
+    }
+}
+
+static int espnow_send(void *ctx, uint8_t dst, const void *buf, size_t len)
+{
+    if (len > BODYNET_MAX_PACKET)
+    {
+        return -1;
+    }
+
+    espnow_packet_t packet;
+    packet.rx_us = 0;
+    packet.len = (uint8_t)len;
+    memcpy(packet.buf, buf, len);
+    if (xQueueSend(tx_queue, &packet, 0) != pdTRUE)
+    {
+        tx_failures++;
+        return -1;
+    }
+    return 0;
+}
+
+static int espnow_recv(void *ctx, void *buf, size_t max_len, int64_t *rx_us)
+{
+    espnow_packet_t packet;
+    if (xQueueReceive(rx_queue, &packet, 0) != pdTRUE)
+    {
+        return 0;
+    }
+
+    size_t len = packet.len < max_len ? packet.len : max_len;
+    memcpy(buf, packet.buf, len);
+    *rx_us = packet.rx_us;
+    return (int)len;
+}
+
+esp_err_t bodynet_espnow_init(uint8_t channel)
+{
+    esp_err_t ret = nvs_flash_init();
+    if (ret == ESP_ERR_NVS_NO_FREE_PAGES || ret == ESP_ERR_NVS_NEW_VERSION_FOUND)
+    {
+        ESP_ERROR_CHECK(nvs_flash_erase());
+        ret = nvs_flash_init();
+    }
+    ESP_ERROR_CHECK(ret);
+
+    rx_queue = xQueueCreateStatic(ESPNOW_QUEUE_LEN, sizeof(espnow_packet_t), rx_queue_storage, &rx_queue_buf);
+    if (rx_queue == NULL)
+    {
+        ESP_LOGE(TAG, "创建接收队列失败");
+        return ESP_ERR_NO_MEM;
+    }
+    memstat_register_pool("ESP-NOW接收队列", sizeof(rx_queue_storage) + sizeof(rx_queue_buf));
+
+    tx_queue = xQueueCreateStatic(ESPNOW_TX_QUEUE_LEN, sizeof(espnow_packet_t), tx_queue_storage, &tx_queue_buf);
+    if (tx_queue == NULL)
+    {
+        ESP_LOGE(TAG, "创建发送队列失败");
+        return ESP_ERR_NO_MEM;
+    }
+    memstat_register_pool("ESP-NOW发送队列", sizeof(tx_queue_storage) + sizeof(tx_queue_buf));
+
+    ESP_ERROR_CHECK(esp_netif_init());
+    ESP_ERROR_CHECK(esp_event_loop_create_default());
+
+    wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
+    ESP_ERROR_CHECK(esp_wifi_init(&cfg));
+    ESP_ERROR_CHECK(esp_wifi_set_storage(WIFI_STORAGE_RAM));
+    ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
+    ESP_ERROR_CHECK(esp_wifi_start());
+    ESP_ERROR_CHECK(esp_wifi_set_channel(channel, WIFI_SECOND_CHAN_NONE));
+
+    ESP_ERROR_CHECK(esp_now_init());
+    ESP_ERROR_CHECK(esp_now_register_recv_cb(espnow_recv_cb));
+
+    esp_now_peer_info_t peer;
+    memset(&peer, 0, sizeof(peer));
+    memcpy(peer.peer_addr, broadcast_mac, ESP_NOW_ETH_ALEN);
+    peer.channel = channel;
+    peer.ifidx = WIFI_IF_STA;
+    peer.encrypt = false;
+    ESP_ERROR_CHECK(esp_now_add_peer(&peer));
+
+    xTaskCreateStatic(espnow_tx_task, "espnow_tx", ESPNOW_TX_STACK_SIZE, NULL, ESPNOW_TX_PRIORITY,
+                      tx_task_stack, &tx_task_buf);
+    memstat_register_pool("ESP-NOW发送任务栈", sizeof(tx_task_stack) + sizeof(tx_task_buf));
+
+    ESP_LOGI(TAG, "ESP-NOW初始化完成 (信道%d)", channel);
+    return ESP_OK;
+}
+
+uint32_t bodynet_espnow_tx_failures(void)
+{
+    return tx_failures;
+}
+
+bodynet_transport_t bodynet_espnow_transport(void)
+{
+    bodynet_transport_t transport = {espnow_send, espnow_recv, NULL};
+    return transport;
+}
@@ -0,0 +1,33 @@
+#ifndef BODYNET_ESPNOW_H
+#define BODYNET_ESPNOW_H
+
+#include "esp_err.h"
+#include "bodynet/bodynet.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    /**
+     * @brief 初始化WiFi(STA)和ESP-NOW, 使用广播收发, 由包头 dst 过滤
+     * @param channel WiFi信道, 所有节点必须一致
+     * @return ESP_OK 成功，其他值表示错误
+     */
+    esp_err_t bodynet_espnow_init(uint8_t channel);
+
+    /**
+     * @brief 获取ESP-NOW传输接口. send 只把包拷贝进发送队列, 由发送任务调用 esp_now_send
+     */
+    bodynet_transport_t bodynet_espnow_transport(void);
+
+    /**
+     * @brief 发送失败次数 (发送队列满或 esp_now_send 失败)
+     */
+    uint32_t bodynet_espnow_tx_failures(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BODYNET_ESPNOW_H
\ No newline at end of file
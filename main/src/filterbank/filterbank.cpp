@@ -0,0 +1,312 @@
+#include "filterbank.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+
+void filterbank_init(filterbank_t *bank)
+{
+    memset(bank, 0, sizeof(*bank));
+    for (int c = 0; c < FILTERBANK_CHANNELS; c++)
+    {
+        bank->b0[c] = 1.0f;
+    }
+    bank->first_order = true;
+}
+
+void filterbank_reset(filterbank_t *bank)
+{
+    memset(bank->z1, 0, sizeof(bank->z1));
+    memset(bank->z2, 0, sizeof(bank->z2));
+    bank->primed = false;
+}
+
+void filterbank_set_biquad(filterbank_t *bank, int channel, float b0, float b1, float b2, float a1, float a2)
+{
+    if (channel < 0 || channel >= FILTERBANK_CHANNELS)
+    {
+        return;
+    }
+    bank->b0[channel] = b0;
+    bank->b1[channel] = b1;
+    bank->b2[channel] = b2;
+    bank->a1[channel] = a1;
+    bank->a2[channel] = a2;
+
+    // 系数变化时重新判断是否可以走一阶路径
+    bank->first_order = true;
+    for (int c = 0; c < FILTERBANK_CHANNELS; c++)
+    {
+        if (bank->b1[c] != 0.0f || bank->b2[c] != 0.0f || bank->a2[c] != 0.0f)
+        {
+            bank->first_order = false;
+            break;
+        }
+    }
+}
+
+void filterbank_set_lowpass_alpha(filterbank_t *bank, int channel, float alpha)
+{
+    if (channel < 0 || channel >= FILTERBANK_CHANNELS)
+    {
+        return;
+    }
+
+    // 一阶滤波器组的其余系数已经是0, 只改 b0/a1, 不需要重新扫描所有通道
+    if (bank->first_order)
+    {
+        bank->b0[channel] = alpha;
+        bank->a1[channel] = -(1.0f - alpha);
+        return;
+    }
+    filterbank_set_biquad(bank, channel, alpha, 0.0f, 0.0f, -(1.0f - alpha), 0.0f);
+}
+
+// 用第一个样本把状态设为直流稳态, 输出从第一个样本开始就等于输入
+static void filterbank_prime(filterbank_t *bank, const float *x)
+{
+    for (int c = 0; c < FILTERBANK_CHANNELS; c++)
+    {
+        float den = 1.0f + bank->a1[c] + bank->a2[c];
+        float gain = fabsf(den) > 1e-6f ? (bank->b0[c] + bank->b1[c] + bank->b2[c]) / den : 1.0f;
+        float y = gain * x[c];
+
+        bank->z2[c] = bank->b2[c] * x[c] - bank->a2[c] * y;
+        bank->z1[c] = bank->b1[c] * x[c] - bank->a1[c] * y + bank->z2[c];
+    }
+    bank->primed = true;
+}
+
+// 一块样本转置到补齐的对齐缓冲: tile[i][c], 补齐通道填0
+static void load_tile(const imu_data_t *in, float (*tile)[FILTERBANK_LANES], int len)
+{
+    for (int i = 0; i < len; i++)
+    {
+        const float *x = &in[i].accel_x;
+        for (int c = 0; c < FILTERBANK_CHANNELS; c++)
+        {
+            tile[i][c] = x[c];
+        }
+        for (int c = FILTERBANK_CHANNELS; c < FILTERBANK_LANES; c++)
+        {
+            tile[i][c] = 0.0f;
+        }
+    }
+}
+
+static void store_tile(const float (*tile)[FILTERBANK_LANES], imu_data_t *out, int len)
+{
+    for (int i = 0; i < len; i++)
+    {
+        float *y = &out[i].accel_x;
+        for (int c = 0; c < FILTERBANK_CHANNELS; c++)
+        {
+            y[c] = tile[i][c];
+        }
+    }
+}
+
+// 通道循环长度固定为 FILTERBANK_LANES, 指针互不重叠, 每个样本的12个通道正好是3个4路向量
+static void process_first_order(filterbank_t *__restrict bank, float (*__restrict tile)[FILTERBANK_LANES], int len)
+{
+    // 一阶: y = b0*x + z1; z1 = -a1*y
+    const float *__restrict b0 = bank->b0;
+    const float *__restrict a1 = bank->a1;
+    float *__restrict z1 = bank->z1;
+
+    for (int i = 0; i < len; i++)
+    {
+        float *__restrict x = tile[i];
+#pragma GCC unroll 1 // 不完全展开, 交给循环向量化 (展开成12条标量后 SLP 向量化失败)
+        for (int c = 0; c < FILTERBANK_LANES; c++)
+        {
+            float yc = b0[c] * x[c] + z1[c];
+            z1[c] = -a1[c] * yc;
+            x[c] = yc;
+        }
+    }
+}
+
+static void process_biquad(filterbank_t *__restrict bank, float (*__restrict tile)[FILTERBANK_LANES], int len)
+{
+    const float *__restrict b0 = bank->b0;
+    const float *__restrict b1 = bank->b1;
+    const float *__restrict b2 = bank->b2;
+    const float *__restrict a1 = bank->a1;
+    const float *__restrict a2 = bank->a2;
+    float *__restrict z1 = bank->z1;
+    float *__restrict z2 = bank->z2;
+
+    for (int i = 0; i < len; i++)
+    {
+        float *__restrict x = tile[i];
+#pragma GCC unroll 1 // 不完全展开, 交给循环向量化 (展开成12条标量后 SLP 向量化失败)
+        for (int c = 0; c < FILTERBANK_LANES; c++)
+        {
+            float xc = x[c];
+            float yc = b0[c] * xc + z1[c];
+            z1[c] = b1[c] * xc - a1[c] * yc + z2[c];
+            z2[c] = b2[c] * xc - a2[c] * yc;
+            x[c] = yc;
+        }
+    }
+}
+
+void filterbank_process(filterbank_t *bank, const imu_data_t *in, imu_data_t *out, int n)
+{
+    if (n <= 0)
+    {
+        return;
+    }
+    if (!bank->primed)
+    {
+        filterbank_prime(bank, &in[0].accel_x);
+    }
+
+    alignas(16) float tile[FILTERBANK_TILE][FILTERBANK_LANES];
+
+    for (int start = 0; start < n; start += FILTERBANK_TILE)
+    {
+        int len = n - start < FILTERBANK_TILE ? n - start : FILTERBANK_TILE;
+
+        load_tile(&in[start], tile, len);
+        if (bank->first_order)
+        {
+            process_first_order(bank, tile, len);
+        }
+        else
+        {
+            process_biquad(bank, tile, len);
+        }
+        store_tile(tile, &out[start], len);
+    }
+}
+
+// ============= 性能对比 =============
+
+// 旧的逐样本逐通道标量低通, 作为对比基准
+typedef struct
+{
+    float alpha;
+    float prev_value;
+    bool initialized;
+} scalar_low_pass_t;
+
+static float scalar_low_pass(scalar_low_pass_t *filter, float new_value)
+{
+    if (!filter->initialized)
+    {
+        filter->prev_value = new_value;
+        filter->initialized = true;
+        return new_value;
+    }
+
+    filter->prev_value = filter->alpha * new_value + (1.0f - filter->alpha) * filter->prev_value;
+    return filter->prev_value;
+}
+
+// 逐样本逐通道的标量biquad (直接I型), 二阶的对比基准; 用第一个样本初始化为直流稳态
+typedef struct
+{
+    float b0, b1, b2, a1, a2;
+    float x1, x2, y1, y2;
+    bool initialized;
+} scalar_biquad_t;
+
+static float scalar_biquad(scalar_biquad_t *f, float x)
+{
+    if (!f->initialized)
+    {
+        float y = x * (f->b0 + f->b1 + f->b2) / (1.0f + f->a1 + f->a2);
+        f->x1 = f->x2 = x;
+        f->y1 = f->y2 = y;
+        f->initialized = true;
+    }
+
+    float y = f->b0 * x + f->b1 * f->x1 + f->b2 * f->x2 - f->a1 * f->y1 - f->a2 * f->y2;
+    f->x2 = f->x1;
+    f->x1 = x;
+    f->y2 = f->y1;
+    f->y1 = y;
+    return y;
+}
+
+#define BENCH_MAX_BLOCK 64
+
+// 二阶巴特沃斯低通, 截止频率为采样率的 1/20
+#define BENCH_B0 0.020083366f
+#define BENCH_B1 0.040166731f
+#define BENCH_B2 0.020083366f
+#define BENCH_A1 -1.561018076f
+#define BENCH_A2 0.641351538f
+
+float filterbank_benchmark(int blocks, int block_len, bool biquad)
+{
+    static imu_data_t in[BENCH_MAX_BLOCK];
+    static imu_data_t out[BENCH_MAX_BLOCK];
+    static filterbank_t bank;
+    static scalar_low_pass_t scalar[FILTERBANK_CHANNELS];
+    static scalar_biquad_t scalar_bq[FILTERBANK_CHANNELS];
+
+    if (block_len > BENCH_MAX_BLOCK)
+    {
+        block_len = BENCH_MAX_BLOCK;
+    }
+
+    for (int i = 0; i < block_len; i++)
+    {
+        float *x = &in[i].accel_x;
+        for (int c = 0; c < FILTERBANK_CHANNELS; c++)
+        {
+            x[c] = (float)((i * 7 + c * 13) % 17) * 0.1f;
+        }
+    }
+
+    filterbank_init(&bank);
+    for (int c = 0; c < FILTERBANK_CHANNELS; c++)
+    {
+        if (biquad)
+        {
+            filterbank_set_biquad(&bank, c, BENCH_B0, BENCH_B1, BENCH_B2, BENCH_A1, BENCH_A2);
+            scalar_bq[c] = {BENCH_B0, BENCH_B1, BENCH_B2, BENCH_A1, BENCH_A2, 0, 0, 0, 0, false};
+        }
+        else
+        {
+            filterbank_set_lowpass_alpha(&bank, c, 0.85f);
+            scalar[c].alpha = 0.85f;
+            scalar[c].initialized = false;
+        }
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (int b = 0; b < blocks; b++)
+    {
+        for (int i = 0; i < block_len; i++)
+        {
+            const float *x = &in[i].accel_x;
+            float *y = &out[i].accel_x;
+            for (int c = 0; c < FILTERBANK_CHANNELS; c++)
+            {
+                y[c] = biquad ? scalar_biquad(&scalar_bq[c], x[c]) : scalar_low_pass(&scalar[c], x[c]);
+            }
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    float check_scalar = out[block_len - 1].mag_z;
+
+    for (int b = 0; b < blocks; b++)
+    {
+        filterbank_process(&bank, in, out, block_len);
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    float check_bank = out[block_len - 1].mag_z;
+
+    float samples = (float)blocks * block_len;
+    float scalar_ns = std::chrono::duration<float, std::nano>(t1 - t0).count() / samples;
+    float bank_ns = std::chrono::duration<float, std::nano>(t2 - t1).count() / samples;
+
+    float diff = fabsf(check_scalar - check_bank);
+    printf("滤波器组性能(%s): 逐样本 %.1fns/样本, 块处理 %.1fns/样本 (%d×%d样本, 输出差 %.6f)\n",
+           biquad ? "二阶" : "一阶", scalar_ns, bank_ns, blocks, block_len, diff);
+    return diff;
+}
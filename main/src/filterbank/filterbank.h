@@ -0,0 +1,75 @@
+#ifndef FILTERBANK_H
+#define FILTERBANK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "imu/imu.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define FILTERBANK_CHANNELS 9 // 与 imu_data_t 字段顺序一致: accel xyz, gyro xyz, mag xyz
+#define FILTERBANK_ACCEL 0    // 加速度通道起始
+#define FILTERBANK_GYRO 3     // 陀螺仪通道起始
+#define FILTERBANK_MAG 6      // 磁力计通道起始
+#define FILTERBANK_LANES 12   // 通道补齐到4的倍数, 内层循环是整数个向量宽度, 补齐的通道系数为0
+#define FILTERBANK_TILE 16    // 块处理时每次转置到对齐缓冲的样本数
+
+    // 9通道biquad滤波器组, 结构体数组(SoA)布局: 同一系数的所有通道连续存放
+    // 转置直接II型: y = b0*x + z1; z1 = b1*x - a1*y + z2; z2 = b2*x - a2*y
+    typedef struct
+    {
+        float b0[FILTERBANK_LANES];
+        float b1[FILTERBANK_LANES];
+        float b2[FILTERBANK_LANES];
+        float a1[FILTERBANK_LANES];
+        float a2[FILTERBANK_LANES];
+        float z1[FILTERBANK_LANES];
+        float z2[FILTERBANK_LANES];
+        bool first_order; // 所有通道 b1 = b2 = a2 = 0, 走一阶快速路径
+        bool primed;      // 状态是否已用第一个样本初始化
+    } filterbank_t;
+
+    /**
+     * @brief 所有通道设为直通, 清空状态
+     */
+    void filterbank_init(filterbank_t *bank);
+
+    /**
+     * @brief 清空状态, 下一个样本重新初始化 (保留系数)
+     */
+    void filterbank_reset(filterbank_t *bank);
+
+    /**
+     * @brief 设置单个通道的biquad系数 (a0 归一化为1), 可在运行中切换
+     */
+    void filterbank_set_biquad(filterbank_t *bank, int channel, float b0, float b1, float b2, float a1, float a2);
+
+    /**
+     * @brief 设置单个通道为一阶低通: y = alpha*x + (1-alpha)*y_prev
+     * @note 滤波器组已是一阶时只改该通道的两个系数, 可每块调用
+     */
+    void filterbank_set_lowpass_alpha(filterbank_t *bank, int channel, float alpha);
+
+    /**
+     * @brief 对 n 个样本 × 9 通道做一次块处理, in 与 out 可以相同
+     * @note 每 FILTERBANK_TILE 个样本拷贝到按 FILTERBANK_LANES 补齐的对齐缓冲, 通道循环固定长度、无别名, 可整段向量化
+     */
+    void filterbank_process(filterbank_t *bank, const imu_data_t *in, imu_data_t *out, int n);
+
+    /**
+     * @brief 对比块处理与逐样本逐通道标量滤波的耗时, 结果打印输出
+     * @param blocks 块数
+     * @param block_len 每块样本数 (≤ 64)
+     * @param biquad 为 true 时所有通道用二阶低通, 否则用一阶低通
+     * @return 两种方法最后一个输出的差, 用于校验
+     */
+    float filterbank_benchmark(int blocks, int block_len, bool biquad);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FILTERBANK_H
\ No newline at end of file
@@ -1,61 +1,267 @@
 #include "imu.h"
+#include "spectral/spectral.h"
+#include "filterbank/filterbank.h"
+#include "imubus/imubus.h"
+#include "imubus/bmi270_fifo.h"
+#include "memstat/memstat.h"
 #include "M5Unified.h"
-#include "freertos/semphr.h"
 #include "esp_timer.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
 #include "math.h"
 #include <string.h>
 
 static imu_data_t latest_data;
+static spectral_features_t latest_spectral;
 static SemaphoreHandle_t data_mutex = NULL;
+static StaticSemaphore_t data_mutex_buf;
+
+// 滤波后样本的环形缓冲, sample_count 为写入的样本总数
+static imu_sample_t sample_ring[IMU_RING_LEN];
+static uint32_t sample_count = 0;
+static uint32_t ring_overruns = 0; // 读取方落后被覆盖的样本数
 
 // ============= IMU数据读取功能 =============
 
+#define IMU_WAKEUP_MS 10        // 总线所有者唤醒周期, 每次突发读取约4帧 (400Hz)
+#define IMU_FIFO_RATE_HZ 400.0f
+#define IMU_FALLBACK_MS 20      // FIFO不可用时逐样本读取的周期
+#define IMU_MAG_DIVIDER 5       // 每5次唤醒读一次磁力计 (20Hz)
+#define IMU_SPECTRAL_DECIMATION 8 // 400Hz 平均降采样到 50Hz 送频谱分析
+#define IMU_BATCH_MAX 24        // 单次唤醒最多处理的样本数
+
+// 低通系数按20Hz整定, 其他采样率换算成相同的时间常数
+#define IMU_FILTER_REF_HZ 20.0f
+#define IMU_MOTION_PERIOD_US 50000 // 运动检测间隔, 与原20Hz判据一致
+#define IMU_MOTION_THRESHOLD 0.1f  // 间隔内加速度变化超过 0.1g 视为运动
+
+static bmi270_fifo_t imu_fifo;
+
+// 9通道低通滤波器组: 加速度 alpha=0.85 (运动时动态切换), 陀螺仪直通, 磁力计 alpha=0.7 (均为20Hz下的值)
+// 一阶低通 y = alpha*x + (1-alpha)*y_prev 对应 b0 = alpha, a1 = -(1-alpha)
+static filterbank_t imu_filters = {
+    .b0 = {0.85f, 0.85f, 0.85f, 1.0f, 1.0f, 1.0f, 0.7f, 0.7f, 0.7f},
+    .b1 = {0},
+    .b2 = {0},
+    .a1 = {-0.15f, -0.15f, -0.15f, 0.0f, 0.0f, 0.0f, -0.3f, -0.3f, -0.3f},
+    .a2 = {0},
+    .z1 = {0},
+    .z2 = {0},
+    .first_order = true,
+    .primed = false};
+
+// 20Hz下的 alpha 换算到 rate_hz: 每个20Hz周期的衰减 (1-alpha) 不变
+static float alpha_at_rate(float alpha_ref, float rate_hz)
+{
+    return 1.0f - powf(1.0f - alpha_ref, IMU_FILTER_REF_HZ / rate_hz);
+}
+
+static void set_accel_alpha(float alpha_ref, float rate_hz)
+{
+    float alpha = alpha_at_rate(alpha_ref, rate_hz);
+    for (int c = FILTERBANK_ACCEL; c < FILTERBANK_ACCEL + 3; c++)
+    {
+        filterbank_set_lowpass_alpha(&imu_filters, c, alpha);
+    }
+}
+
+// 运动时使用较强的滤波, 静止时使用较弱的滤波, 提高响应性; 每批最多判断一次
+static void update_motion_alpha(const imu_data_t *raw, int64_t now_us, float rate_hz)
+{
+    static float ref_accel[3] = {0};
+    static int64_t ref_us = 0;
+
+    if (now_us - ref_us < IMU_MOTION_PERIOD_US)
+    {
+        return;
+    }
+
+    float dx = raw->accel_x - ref_accel[0];
+    float dy = raw->accel_y - ref_accel[1];
+    float dz = raw->accel_z - ref_accel[2];
+    bool motion = sqrtf(dx * dx + dy * dy + dz * dz) > IMU_MOTION_THRESHOLD;
+    set_accel_alpha(motion ? 0.7f : 0.9f, rate_hz);
+
+    ref_accel[0] = raw->accel_x;
+    ref_accel[1] = raw->accel_y;
+    ref_accel[2] = raw->accel_z;
+    ref_us = now_us;
+}
+
+// 本任务是I2C总线的唯一所有者: 执行其他任务排队的总线请求, 调用 M5.update(),
+// 每次唤醒一次突发读取 BMI270 FIFO, 整批滤波后写入样本环形缓冲
+// parameter: 每批样本写入后用任务通知唤醒的读取任务 (TaskHandle_t), 可为 NULL
 void imu_task(void *parameter)
 {
-    // 创建互斥锁
-    data_mutex = xSemaphoreCreateMutex();
+    TaskHandle_t reader = (TaskHandle_t)parameter;
+
+    // 创建互斥锁 (静态存储, 不占用堆)
+    data_mutex = xSemaphoreCreateMutexStatic(&data_mutex_buf);
     if (data_mutex == NULL)
     {
         printf("创建互斥锁失败\r\n");
         return;
     }
 
-    m5::imu_data_t m5_data;
-    printf("IMU任务开始运行 (50Hz)\r\n");
+    if (imubus_init(imubus_m5_ops()) != 0)
+    {
+        return;
+    }
+
+    // FIFO给出芯片坐标轴, 按板级映射转换成与 M5.Imu 相同的坐标轴
+    bool use_fifo = bmi270_fifo_init(&imu_fifo, imubus_arbitrated_ops(), BMI270_ADDR, BMI270_ODR_400HZ,
+                                     IMU_WAKEUP_MS, &bmi270_axis_atoms3r) == 0;
+    if (!use_fifo)
+    {
+        printf("BMI270 FIFO配置失败, 改用逐样本读取\r\n");
+    }
+
+    float rate_hz = use_fifo ? IMU_FIFO_RATE_HZ : 1000.0f / IMU_FALLBACK_MS;
+    int64_t sample_period_us = (int64_t)(1000000.0f / rate_hz);
+    set_accel_alpha(0.85f, rate_hz);
+    for (int c = FILTERBANK_MAG; c < FILTERBANK_MAG + 3; c++)
+    {
+        filterbank_set_lowpass_alpha(&imu_filters, c, alpha_at_rate(0.7f, rate_hz));
+    }
+
+    imu_data_t batch[IMU_BATCH_MAX];
+    imu_data_t decim = {};
+    int decim_count = 0;
+    float mag[3] = {0};
+    spectral_features_t features;
+    bool new_features = false;
+    uint32_t wakeups = 0;
 
+    // 频谱分析: 50Hz采样, 64点窗口, 每8个样本输出一次
+    spectral_init(50.0f, 8);
+
+    printf("IMU任务开始运行 (%s)\r\n", use_fifo ? "FIFO 400Hz" : "50Hz");
+
+    TickType_t last_wake = xTaskGetTickCount();
     while (1)
     {
-        // 更新M5设备和IMU
+        // 其他任务的总线请求
+        imubus_service();
+
+        // 按键等状态更新, 只在总线所有者任务中调用
         M5.update();
 
-        if (M5.Imu.update())
+        int n = 0;
+        if (!use_fifo || wakeups % IMU_MAG_DIVIDER == 0)
         {
-            // 读取IMU数据
-            m5_data = M5.Imu.getImuData();
+            if (M5.Imu.update())
+            {
+                m5::imu_data_t m5_data = M5.Imu.getImuData();
+                mag[0] = m5_data.mag.x;
+                mag[1] = m5_data.mag.y;
+                mag[2] = m5_data.mag.z;
 
-            // 更新最新数据
-            if (xSemaphoreTake(data_mutex, pdMS_TO_TICKS(10)) == pdTRUE)
+                if (!use_fifo)
+                {
+                    batch[0].accel_x = m5_data.accel.x;
+                    batch[0].accel_y = m5_data.accel.y;
+                    batch[0].accel_z = m5_data.accel.z;
+                    batch[0].gyro_x = m5_data.gyro.x;
+                    batch[0].gyro_y = m5_data.gyro.y;
+                    batch[0].gyro_z = m5_data.gyro.z;
+                    n = 1;
+                }
+            }
+        }
+
+        if (use_fifo)
+        {
+            n = bmi270_fifo_drain(&imu_fifo, batch, IMU_BATCH_MAX);
+        }
+        if (n <= 0)
+        {
+            wakeups++;
+            vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(use_fifo ? IMU_WAKEUP_MS : IMU_FALLBACK_MS));
+            continue;
+        }
+
+        // 批内最后一帧对应本次唤醒时刻, 之前的帧按采样周期回推
+        int64_t now_us = esp_timer_get_time();
+
+        // 频谱分析用未滤波的数据 (低通会衰减抖动频带), 在锁外进行, 只有本任务访问
+        for (int i = 0; i < n; i++)
+        {
+            batch[i].mag_x = mag[0];
+            batch[i].mag_y = mag[1];
+            batch[i].mag_z = mag[2];
+
+            if (!use_fifo)
             {
-                latest_data.accel_x = m5_data.accel.x;
-                latest_data.accel_y = m5_data.accel.y;
-                latest_data.accel_z = m5_data.accel.z;
+                new_features |= spectral_push(&batch[i], &features);
+                continue;
+            }
 
-                latest_data.gyro_x = m5_data.gyro.x;
-                latest_data.gyro_y = m5_data.gyro.y;
-                latest_data.gyro_z = m5_data.gyro.z;
+            float *sum = &decim.accel_x;
+            const float *x = &batch[i].accel_x;
+            for (int c = 0; c < 9; c++)
+            {
+                sum[c] += x[c];
+            }
+            if (++decim_count == IMU_SPECTRAL_DECIMATION)
+            {
+                for (int c = 0; c < 9; c++)
+                {
+                    sum[c] /= IMU_SPECTRAL_DECIMATION;
+                }
+                new_features |= spectral_push(&decim, &features);
+                memset(&decim, 0, sizeof(decim));
+                decim_count = 0;
+            }
+        }
 
-                latest_data.mag_x = m5_data.mag.x;
-                latest_data.mag_y = m5_data.mag.y;
-                latest_data.mag_z = m5_data.mag.z;
+        // 整批滤波 (9通道一次完成)
+        update_motion_alpha(&batch[n - 1], now_us, rate_hz);
+        filterbank_process(&imu_filters, batch, batch, n);
+
+        // 写入环形缓冲和最新数据
+        if (xSemaphoreTake(data_mutex, pdMS_TO_TICKS(10)) == pdTRUE)
+        {
+            for (int i = 0; i < n; i++)
+            {
+                imu_sample_t *s = &sample_ring[sample_count % IMU_RING_LEN];
+                s->t_us = now_us - (int64_t)(n - 1 - i) * sample_period_us;
+                s->data = batch[i];
+                sample_count++;
+            }
+            latest_data = batch[n - 1];
+            if (new_features)
+            {
+                latest_spectral = features;
+                new_features = false;
+            }
+            xSemaphoreGive(data_mutex);
 
-                xSemaphoreGive(data_mutex);
+            if (reader != NULL)
+            {
+                xTaskNotifyGive(reader);
             }
         }
 
-        vTaskDelay(pdMS_TO_TICKS(20)); // 50Hz
+        wakeups++;
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(use_fifo ? IMU_WAKEUP_MS : IMU_FALLBACK_MS));
     }
 }
 
+// 显示FIFO读取和总线统计
+void imu_print_bus_stats(void)
+{
+    imubus_stats_t stats;
+    imubus_get_stats(&stats);
+
+    printf("FIFO: 突发读取%lu次 帧%lu 丢帧%lu 积压追读%lu次 样本%lu 读取落后覆盖%lu\n",
+           (unsigned long)imu_fifo.bursts, (unsigned long)imu_fifo.frames,
+           (unsigned long)imu_fifo.skipped, (unsigned long)imu_fifo.backlog,
+           (unsigned long)sample_count, (unsigned long)ring_overruns);
+    printf("I2C总线: 事务%lu 字节%lu 排队请求%lu 错误%lu\n",
+           (unsigned long)stats.transactions, (unsigned long)stats.bytes,
+           (unsigned long)stats.queued, (unsigned long)stats.errors);
+}
+
 int imu_get_data(imu_data_t *data)
 {
     if (data == NULL)
@@ -71,38 +277,54 @@ int imu_get_data(imu_data_t *data)
     return 0;
 }
 
-// ============= 欧拉角计算 =============
-
-// 简单的低通滤波器
-typedef struct
+int imu_read_samples(uint32_t *cursor, imu_sample_t *out, int max_samples)
 {
-    float alpha;
-    float prev_value;
-    bool initialized;
-} low_pass_filter_t;
-
-// 滤波器实例
-static low_pass_filter_t accel_x_filter = {.alpha = 0.85f, .prev_value = 0, .initialized = false};
-static low_pass_filter_t accel_y_filter = {.alpha = 0.85f, .prev_value = 0, .initialized = false};
-static low_pass_filter_t accel_z_filter = {.alpha = 0.85f, .prev_value = 0, .initialized = false};
-static low_pass_filter_t mag_x_filter = {.alpha = 0.7f, .prev_value = 0, .initialized = false};
-static low_pass_filter_t mag_y_filter = {.alpha = 0.7f, .prev_value = 0, .initialized = false};
-static low_pass_filter_t mag_z_filter = {.alpha = 0.7f, .prev_value = 0, .initialized = false};
-
-// 低通滤波函数
-float apply_low_pass(low_pass_filter_t *filter, float new_value)
-{
-    if (!filter->initialized)
+    if (cursor == NULL || out == NULL || max_samples <= 0)
     {
-        filter->prev_value = new_value;
-        filter->initialized = true;
-        return new_value;
+        return 0;
+    }
+    if (xSemaphoreTake(data_mutex, pdMS_TO_TICKS(100)) != pdTRUE)
+    {
+        return 0;
     }
 
-    filter->prev_value = filter->alpha * new_value + (1.0f - filter->alpha) * filter->prev_value;
-    return filter->prev_value;
+    // 落后超过缓冲长度时从最旧的样本开始
+    uint32_t available = sample_count - *cursor;
+    if (available > IMU_RING_LEN)
+    {
+        ring_overruns += available - IMU_RING_LEN;
+        *cursor = sample_count - IMU_RING_LEN;
+        available = IMU_RING_LEN;
+    }
+
+    int n = available < (uint32_t)max_samples ? (int)available : max_samples;
+    for (int i = 0; i < n; i++)
+    {
+        out[i] = sample_ring[(*cursor + i) % IMU_RING_LEN];
+    }
+    *cursor += n;
+
+    xSemaphoreGive(data_mutex);
+    return n;
 }
 
+int imu_get_spectral(spectral_features_t *features)
+{
+    if (features == NULL)
+    {
+        return 0;
+    }
+    if (xSemaphoreTake(data_mutex, pdMS_TO_TICKS(100)) == pdTRUE)
+    {
+        *features = latest_spectral;
+        xSemaphoreGive(data_mutex);
+        return 1;
+    }
+    return 0;
+}
+
+// ============= 欧拉角计算 =============
+
 // 角度标准化到 [-180, 180]
 float normalize_angle(float angle)
 {
@@ -113,17 +335,16 @@ float normalize_angle(float angle)
     return angle;
 }
 
-// 优化的欧拉角计算
-void imu_calc_euler_optimized(const imu_data_t *raw, imu_euler_t *euler)
+// 优化的欧拉角计算, 输入已在 imu_task 中滤波
+void imu_calc_euler_optimized(const imu_data_t *data, imu_euler_t *euler)
 {
-    // 滤波处理
-    float ax = apply_low_pass(&accel_x_filter, raw->accel_x);
-    float ay = apply_low_pass(&accel_y_filter, raw->accel_y);
-    float az = apply_low_pass(&accel_z_filter, raw->accel_z);
+    float ax = data->accel_x;
+    float ay = data->accel_y;
+    float az = data->accel_z;
 
-    float mx = apply_low_pass(&mag_x_filter, raw->mag_x);
-    float my = apply_low_pass(&mag_y_filter, raw->mag_y);
-    float mz = apply_low_pass(&mag_z_filter, raw->mag_z);
+    float mx = data->mag_x;
+    float my = data->mag_y;
+    float mz = data->mag_z;
 
     // 归一化加速度
     float a_norm = sqrt(ax * ax + ay * ay + az * az);
@@ -140,6 +361,12 @@ void imu_calc_euler_optimized(const imu_data_t *raw, imu_euler_t *euler)
         az = 1;
     }
 
+    // 倾斜四元数 (模板匹配使用, 避免pitch ±90°附近roll翻转)
+    euler->tilt = quat_from_gravity(ax, ay, az);
+    euler->gyro_x = data->gyro_x;
+    euler->gyro_y = data->gyro_y;
+    euler->gyro_z = data->gyro_z;
+
     // 计算Roll和Pitch
     euler->roll = atan2(ay, az) * 57.2958f;
     float pitch_val = fmaxf(-1.0f, fminf(1.0f, -ax));
@@ -205,413 +432,20 @@ void imu_calc_euler_optimized(const imu_data_t *raw, imu_euler_t *euler)
     prev_yaw = euler->yaw;
 }
 
-// 带运动检测的智能姿态计算
-void imu_calc_euler_smart(const imu_data_t *raw, imu_euler_t *euler)
+// 带运动检测的智能姿态计算: 运动自适应的滤波系数由 imu_task 按批切换
+void imu_calc_euler_smart(const imu_data_t *data, imu_euler_t *euler)
 {
-    // 检测是否在运动中
-    static float prev_accel[3] = {0};
-    static bool motion_detected = false;
-
-    float accel_change = sqrt(
-        (raw->accel_x - prev_accel[0]) * (raw->accel_x - prev_accel[0]) +
-        (raw->accel_y - prev_accel[1]) * (raw->accel_y - prev_accel[1]) +
-        (raw->accel_z - prev_accel[2]) * (raw->accel_z - prev_accel[2]));
-
-    motion_detected = (accel_change > 0.1f); // 运动阈值
-
-    if (motion_detected)
-    {
-        // 运动时使用较强的滤波
-        accel_x_filter.alpha = 0.7f;
-        accel_y_filter.alpha = 0.7f;
-        accel_z_filter.alpha = 0.7f;
-    }
-    else
-    {
-        // 静止时使用较弱的滤波，提高响应性
-        accel_x_filter.alpha = 0.9f;
-        accel_y_filter.alpha = 0.9f;
-        accel_z_filter.alpha = 0.9f;
-    }
-
-    // 使用优化的算法
-    imu_calc_euler_optimized(raw, euler);
-
-    // 更新上次加速度
-    prev_accel[0] = raw->accel_x;
-    prev_accel[1] = raw->accel_y;
-    prev_accel[2] = raw->accel_z;
+    imu_calc_euler_optimized(data, euler);
 }
 
-// ============= 工具函数 =============
-
-// 根据时长匹配最接近的音符
-note_duration_t match_note_duration(uint32_t duration_ms)
-{
-    uint32_t durations[] = {NOTE_SIXTEENTH, NOTE_EIGHTH, NOTE_QUARTER, NOTE_HALF};
-    const char *names[] = {"十六分音符", "八分音符", "四分音符", "二分音符"};
-
-    int best_match = 0;
-    uint32_t min_diff = abs((int)duration_ms - (int)durations[0]);
-
-    for (int i = 1; i < 4; i++)
-    {
-        uint32_t diff = abs((int)duration_ms - (int)durations[i]);
-        if (diff < min_diff)
-        {
-            min_diff = diff;
-            best_match = i;
-        }
-    }
-
-    printf("音符: %s\n", names[best_match]);
-
-    return (note_duration_t)durations[best_match];
-}
-
-// 简化的动作名称
-const char *get_action_name(simple_action_t action)
-{
-    switch (action)
-    {
-    case ACTION_TILT_UP:
-        return "向上倾斜";
-    case ACTION_TILT_DOWN:
-        return "向下倾斜";
-    default:
-        return "无动作";
-    }
-}
-
-// ============= 三点检测算法 =============
-
-// 三个特征点定义
-typedef struct
-{
-    float roll;
-    float pitch;
-    float tolerance;
-    const char *name;
-} feature_point_t;
-
-// 动作模板
-typedef struct
-{
-    feature_point_t point1;
-    feature_point_t point2;
-    feature_point_t point3;
-    uint32_t max_duration_ms; // 最大完成时间
-    simple_action_t action_id;
-    const char *action_name;
-} three_point_template_t;
-
-// 定义动作模板 - 只保留这一个，删除第539行的重复定义
-static const three_point_template_t three_point_templates[] = {
-
-    // 向下倾斜：roll 0° -> -25° -> -50°
-    {
-        .point1 = {0.0f, 0.0f, 25.0f, "起始点"},   // 增大容差
-        .point2 = {-25.0f, 0.0f, 20.0f, "中间点"}, // 增大容差
-        .point3 = {-50.0f, 0.0f, 20.0f, "结束点"}, // 增大容差
-        .max_duration_ms = 1000,                   // 保留但仅用于显示
-        .action_id = ACTION_TILT_DOWN,
-        .action_name = "向下倾斜"},
-
-    // 向上倾斜：roll -50° -> -25° -> 0°
-    {
-        .point1 = {-50.0f, 0.0f, 25.0f, "起始点"},
-        .point2 = {-25.0f, 0.0f, 20.0f, "中间点"},
-        .point3 = {0.0f, 0.0f, 20.0f, "结束点"},
-        .max_duration_ms = 1000,
-        .action_id = ACTION_TILT_UP,
-        .action_name = "向上倾斜"},
-
-    // 举手放下：roll -50° -> -25° -> 0°
-    {
-        .point1 = {40.0f, -80.0f, 25.0f, "起始点"},
-        .point2 = {20.0f, -40.0f, 20.0f, "中间点"},
-        .point3 = {0.0f, 0.0f, 20.0f, "结束点"},
-        .max_duration_ms = 1000,
-        .action_id = HAND_DOWN,
-        .action_name = "举手放下"},
-
-    // 举手：roll -50° -> -25° -> 0°
-    {
-        .point1 = {10.0f, -10.0f, 25.0f, "起始点"},
-        .point2 = {20.0f, -40.0f, 20.0f, "中间点"},
-        .point3 = {40.0f, -80.0f, 20.0f, "结束点"},
-        .max_duration_ms = 1000,
-        .action_id = HAND_UP,
-        .action_name = "举手"},
-
-    // 平上举：roll -50° -> -25° -> 0°
-    {
-        .point1 = {10.0f, -60.0f, 25.0f, "起始点"},
-        .point2 = {40.0f, -60.0f, 20.0f, "中间点"},
-        .point3 = {80.0f, -60.0f, 20.0f, "结束点"},
-        .max_duration_ms = 1000,
-        .action_id = PING_SHANGJU,
-        .action_name = "平上举"},
-
-};
-
-// 检测状态
-typedef enum
-{
-    POINT_STATE_IDLE,     // 空闲，等待第一个点
-    POINT_STATE_POINT1,   // 已检测到第一个点
-    POINT_STATE_POINT2,   // 已检测到第二个点
-    POINT_STATE_COMPLETED // 动作完成
-} point_state_t;
-
-// 三点检测器
-typedef struct
-{
-    point_state_t state;
-    int current_template;    // 当前匹配的模板索引
-    uint32_t start_time;     // 动作开始时间
-    uint32_t point1_time;    // 第一个点时间
-    uint32_t point2_time;    // 第二个点时间
-    uint32_t point3_time;    // 第三个点时间
-    uint32_t last_detection; // 上次检测完成时间
-} three_point_detector_t;
-
-static three_point_detector_t detector = {
-    .state = POINT_STATE_IDLE,
-    .current_template = -1,
-    .start_time = 0,
-    .point1_time = 0,
-    .point2_time = 0,
-    .point3_time = 0,
-    .last_detection = 0};
-
-// 改进的点匹配函数 - 只保留这一个，删除第560行的重复定义
-bool matches_point(const imu_euler_t *euler, const feature_point_t *point)
-{
-    float roll_diff = fabs(euler->roll - point->roll);
-    float pitch_diff = fabs(euler->pitch - point->pitch);
-
-    // 对Roll轴给予更大的权重，因为主要动作是Roll变化
-    float weighted_distance = sqrt(
-        (roll_diff * roll_diff) +
-        (pitch_diff * pitch_diff * 0.5f) // Pitch误差权重降低
-    );
-
-    return weighted_distance <= point->tolerance;
-}
-
-// 三点检测主函数
-simple_action_t detect_three_point_action(const imu_euler_t *euler, uint32_t *execution_time, note_duration_t *note_type)
-{
-    uint32_t current_time = esp_timer_get_time() / 1000;
-    const int num_templates = sizeof(three_point_templates) / sizeof(three_point_templates[0]);
-
-    switch (detector.state)
-    {
-    case POINT_STATE_IDLE:
-        // 寻找第一个点的匹配
-        for (int i = 0; i < num_templates; i++)
-        {
-            if (matches_point(euler, &three_point_templates[i].point1))
-            {
-                detector.state = POINT_STATE_POINT1;
-                detector.current_template = i;
-                detector.start_time = current_time;
-                detector.point1_time = current_time;
-
-                printf("🎯 第1点: %s - %s (R=%.1f°)\n",
-                       three_point_templates[i].action_name,
-                       three_point_templates[i].point1.name,
-                       euler->roll);
-                break;
-            }
-        }
-        break;
-
-    case POINT_STATE_POINT1:
-    {
-        const three_point_template_t *action_template = &three_point_templates[detector.current_template];
-
-        // 检查是否仍在第一个点附近
-        bool still_at_point1 = matches_point(euler, &action_template->point1);
-
-        // 如果离开了当前第一个点，检查是否匹配其他第一个点
-        if (!still_at_point1)
-        {
-            // 先检查是否到达当前模板的第二个点
-            if (matches_point(euler, &action_template->point2))
-            {
-                detector.state = POINT_STATE_POINT2;
-                detector.point2_time = current_time; // 从第二个点开始计时！
-
-                printf("🎯 第2点: %s (R=%.1f°) - 开始计时\n",
-                       action_template->point2.name,
-                       euler->roll);
-                break;
-            }
-
-            // 如果没到第二个点，检查是否匹配其他模板的第一个点
-            bool found_new_start = false;
-            for (int i = 0; i < num_templates; i++)
-            {
-                if (matches_point(euler, &three_point_templates[i].point1))
-                {
-                    // 切换到新的第一个点
-                    detector.current_template = i;
-                    detector.start_time = current_time;
-                    detector.point1_time = current_time;
-
-                    printf("🔄 切换到新起点: %s - %s (R=%.1f°)\n",
-                           three_point_templates[i].action_name,
-                           three_point_templates[i].point1.name,
-                           euler->roll);
-                    found_new_start = true;
-                    break;
-                }
-            }
-
-            // 如果既不在任何第一个点，也没到第二个点，重置为空闲
-            if (!found_new_start)
-            {
-                printf("🔄 离开第1点且无新匹配，重置\n");
-                detector.state = POINT_STATE_IDLE;
-            }
-        }
-        else
-        {
-            // 仍在第一个点，检查第二个点
-            if (matches_point(euler, &action_template->point2))
-            {
-                detector.state = POINT_STATE_POINT2;
-                detector.point2_time = current_time; // 从第二个点开始计时！
-
-                printf("🎯 第2点: %s (R=%.1f°) - 开始计时\n",
-                       action_template->point2.name,
-                       euler->roll);
-            }
-        }
-
-        // 安全超时机制（防止卡死，但时间延长到10秒）
-        uint32_t elapsed_from_start = current_time - detector.start_time;
-        if (elapsed_from_start > 10000)
-        {
-            printf("⏰ 安全超时10秒，重置\n");
-            detector.state = POINT_STATE_IDLE;
-        }
-        break;
-    }
-
-    case POINT_STATE_POINT2:
-    {
-        const three_point_template_t *action_template = &three_point_templates[detector.current_template];
-
-        // 从第二个点开始计算超时时间（1秒）
-        uint32_t elapsed_from_point2 = current_time - detector.point2_time;
-
-        // 超时检查：从第二个点开始1秒内必须完成
-        if (elapsed_from_point2 > 1000)
-        {
-            printf("⏰ 从第2点超时1秒，重置\n");
-            detector.state = POINT_STATE_IDLE;
-            break;
-        }
-
-        // 检查第三个点
-        if (matches_point(euler, &action_template->point3))
-        {
-            detector.point3_time = current_time;
-
-            // 计算从第二个点到第三个点的时间作为执行时间
-            uint32_t execution_duration = current_time - detector.point2_time;
-            uint32_t total_time = current_time - detector.start_time;
-
-            // 动作完成！
-            *execution_time = execution_duration;
-            *note_type = match_note_duration(execution_duration);
-
-            printf("🎯 第3点: %s (R=%.1f°)\n",
-                   action_template->point3.name, euler->roll);
-            printf("✅ %s 完成! 执行时间: %lums (总时间: %lums)\n",
-                   action_template->action_name, execution_duration, total_time);
-
-            detector.state = POINT_STATE_COMPLETED;
-            detector.last_detection = current_time;
-
-            return action_template->action_id;
-        }
-        break;
-    }
-
-    case POINT_STATE_COMPLETED:
-        // 立即重置，支持连续检测
-        detector.state = POINT_STATE_IDLE;
-        printf("🔄 立即准备下一个动作检测\n");
-        break;
-    }
-
-    return ACTION_NONE;
-}
-
-// 改进版显示状态函数，显示动态切换信息
-void print_three_point_status(const imu_euler_t *euler)
-{
-    printf("当前姿态: Roll=%.1f° Pitch=%.1f°\n", euler->roll, euler->pitch);
-
-    const char *state_names[] = {"空闲", "等待第2点", "等待第3点", "已完成"};
-    printf("检测状态: %s\n", state_names[detector.state]);
-
-    if (detector.current_template >= 0)
-    {
-        const three_point_template_t *action_template = &three_point_templates[detector.current_template];
-        printf("当前动作: %s\n", action_template->action_name);
-
-        if (detector.state == POINT_STATE_POINT1)
-        {
-            uint32_t elapsed = (esp_timer_get_time() / 1000) - detector.start_time;
-            bool at_point1 = matches_point(euler, &action_template->point1);
-
-            printf("第1点状态: %s (已用时: %lums)\n",
-                   at_point1 ? "在点上" : "已离开", elapsed);
-            printf("目标: 第2点 Roll=%.1f° (容差±%.1f°)\n",
-                   action_template->point2.roll, action_template->point2.tolerance);
-        }
-        else if (detector.state == POINT_STATE_POINT2)
-        {
-            uint32_t elapsed_from_point2 = (esp_timer_get_time() / 1000) - detector.point2_time;
-            uint32_t remaining = elapsed_from_point2 < 1000 ? 1000 - elapsed_from_point2 : 0;
-
-            printf("第2点已用时: %lums / 1000ms (剩余: %lums)\n",
-                   elapsed_from_point2, remaining);
-            printf("目标: 第3点 Roll=%.1f° (容差±%.1f°)\n",
-                   action_template->point3.roll, action_template->point3.tolerance);
-        }
-    }
-
-    // 显示当前位置匹配情况
-    const int num_templates = sizeof(three_point_templates) / sizeof(three_point_templates[0]);
-    int match_count = 0;
-    for (int i = 0; i < num_templates; i++)
-    {
-        const three_point_template_t *tmpl = &three_point_templates[i];
-
-        if (matches_point(euler, &tmpl->point1))
-        {
-            printf("可启动: %s (第1点匹配)\n", tmpl->action_name);
-            match_count++;
-        }
-    }
-
-    if (match_count == 0 && detector.state == POINT_STATE_IDLE)
-    {
-        printf("当前位置无匹配的起始点\n");
-    }
-}
+// ============= 内存登记 =============
 
-// 重置三点检测器
-void reset_three_point_detector(void)
+// 登记本模块的静态存储, 供启动时内存预算报告
+void imu_register_memory(void)
 {
-    detector.state = POINT_STATE_IDLE;
-    detector.current_template = -1;
-    detector.last_detection = 0;
-    printf("三点检测器已重置\n");
+    memstat_register_pool("imu最新数据", sizeof(latest_data) + sizeof(latest_spectral) + sizeof(data_mutex_buf));
+    memstat_register_pool("imu样本环形缓冲", sizeof(sample_ring));
+    memstat_register_pool("BMI270 FIFO", sizeof(imu_fifo));
+    memstat_register_pool("imu滤波器组", sizeof(imu_filters));
+    memstat_register_pool("三点检测器", three_point_static_bytes());
 }
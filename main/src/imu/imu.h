@@ -2,8 +2,10 @@
 #define IMU_H
 
 #include <stdint.h>
+#include <stddef.h>
 #include <stdbool.h>
 #include <math.h>
+#include "quat/quat.h"
 
 #ifdef __cplusplus
 extern "C"
@@ -18,10 +20,21 @@ extern "C"
         float mag_x, mag_y, mag_z;
     } imu_data_t;
 
+    // 带时间戳的滤波后样本, imu_task 按IMU采样率写入环形缓冲
+    typedef struct
+    {
+        int64_t t_us;
+        imu_data_t data;
+    } imu_sample_t;
+
+#define IMU_RING_LEN 64 // 400Hz 下约160ms; 主循环每批被唤醒读取, 余量留给显示刷新等偶尔的阻塞
+
     // 欧拉角结构
     typedef struct
     {
         float roll, pitch, yaw;
+        quat_t tilt; // 倾斜四元数(不含yaw), 用于模板匹配, pitch ±90° 处不奇异
+        float gyro_x, gyro_y, gyro_z; // 机体角速度(度/秒), 与加速度同一坐标轴, 预测触发外推用
     } imu_euler_t;
 
     // 简单动作类型
@@ -44,11 +57,27 @@ extern "C"
         NOTE_HALF = 1000
     } note_duration_t;
 
+    // 预测触发事件
+    typedef enum
+    {
+        NOTE_EVENT_NONE = 0,
+        NOTE_EVENT_ONSET,   // 提前起音(预测动作即将完成)
+        NOTE_EVENT_CONFIRM, // 提前起音被第3点确认
+        NOTE_EVENT_CANCEL,  // 提前起音被取消, 需要快速释放
+        NOTE_EVENT_TRIGGER  // 未预测到, 在第3点正常触发
+    } note_event_t;
+
+    struct spectral_features;
+
     // 基础IMU函数
-    void imu_task(void *parameter);
-    int imu_get_data(imu_data_t *data);
-    void imu_calc_euler_smart(const imu_data_t *raw, imu_euler_t *euler);
-    void imu_calc_euler_optimized(const imu_data_t *raw, imu_euler_t *euler);
+    void imu_task(void *parameter); // parameter: 每批样本写入后通知的任务句柄, 可为 NULL
+    int imu_get_data(imu_data_t *data);                                          // 最新的滤波后样本
+    int imu_read_samples(uint32_t *cursor, imu_sample_t *out, int max_samples); // cursor 为已读样本总数, 首次传0; 返回新样本数
+    int imu_get_spectral(struct spectral_features *features); // 最新的频谱特征, 见 spectral/spectral.h
+    void imu_print_bus_stats(void);
+    void imu_register_memory(void); // 登记静态存储, 见 memstat/memstat.h
+    void imu_calc_euler_smart(const imu_data_t *data, imu_euler_t *euler);     // 输入为 imu_task 已滤波的样本
+    void imu_calc_euler_optimized(const imu_data_t *data, imu_euler_t *euler);
 
     // 工具函数
     note_duration_t match_note_duration(uint32_t duration_ms);
@@ -59,6 +88,20 @@ extern "C"
     void print_three_point_status(const imu_euler_t *euler);
     void reset_three_point_detector(void);
 
+    // 预测触发
+    note_event_t detect_three_point_predictive(const imu_euler_t *euler, simple_action_t *action, uint32_t *execution_time, note_duration_t *note_type);
+    void print_prediction_stats(void);
+
+    // 以四元数姿态重新定义模板特征点 (point_index: 0~2), 容差为测地角(度)
+    bool three_point_set_orientation(simple_action_t action, int point_index, const quat_t *q, float tolerance_deg);
+    bool three_point_get_orientation(simple_action_t action, int point_index, quat_point_t *point); // 当前生效的特征点(换算后的容差)
+
+    // 检测器使用的毫秒时钟, 默认 esp_timer; 轨迹回放时注入样本时间, 传 NULL 恢复默认
+    typedef uint32_t (*three_point_clock_t)(void);
+    void three_point_set_clock(three_point_clock_t clock);
+
+    size_t three_point_static_bytes(void); // 检测器和预测器的静态存储
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,799 @@
+#include "imu.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#ifdef ESP_PLATFORM
+#include "esp_timer.h"
+#else
+#include <chrono>
+#endif
+
+// 三点检测与预测触发, 不访问传感器和RTOS, 可在主机上回放轨迹
+
+// ============= 时钟 =============
+
+// 默认时钟: 目标板用 esp_timer, 主机用 steady_clock
+static uint32_t default_clock_ms(void)
+{
+#ifdef ESP_PLATFORM
+    return esp_timer_get_time() / 1000;
+#else
+    return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+}
+
+static three_point_clock_t now_ms = default_clock_ms;
+
+void three_point_set_clock(three_point_clock_t clock)
+{
+    now_ms = clock != NULL ? clock : default_clock_ms;
+}
+
+// ============= 工具函数 =============
+
+// 根据时长匹配最接近的音符
+note_duration_t match_note_duration(uint32_t duration_ms)
+{
+    uint32_t durations[] = {NOTE_SIXTEENTH, NOTE_EIGHTH, NOTE_QUARTER, NOTE_HALF};
+    const char *names[] = {"十六分音符", "八分音符", "四分音符", "二分音符"};
+
+    int best_match = 0;
+    uint32_t min_diff = abs((int)duration_ms - (int)durations[0]);
+
+    for (int i = 1; i < 4; i++)
+    {
+        uint32_t diff = abs((int)duration_ms - (int)durations[i]);
+        if (diff < min_diff)
+        {
+            min_diff = diff;
+            best_match = i;
+        }
+    }
+
+    printf("音符: %s\n", names[best_match]);
+
+    return (note_duration_t)durations[best_match];
+}
+
+// 简化的动作名称
+const char *get_action_name(simple_action_t action)
+{
+    switch (action)
+    {
+    case ACTION_TILT_UP:
+        return "向上倾斜";
+    case ACTION_TILT_DOWN:
+        return "向下倾斜";
+    case HAND_DOWN:
+        return "举手放下";
+    case HAND_UP:
+        return "举手";
+    case PING_SHANGJU:
+        return "平上举";
+    default:
+        return "无动作";
+    }
+}
+
+// ============= 三点检测算法 =============
+
+// 三个特征点定义
+typedef struct
+{
+    float roll;
+    float pitch;
+    float tolerance;
+    const char *name;
+} feature_point_t;
+
+// 动作模板
+typedef struct
+{
+    feature_point_t point1;
+    feature_point_t point2;
+    feature_point_t point3;
+    uint32_t max_duration_ms; // 最大完成时间
+    simple_action_t action_id;
+    const char *action_name;
+} three_point_template_t;
+
+// 定义动作模板 - 只保留这一个，删除第539行的重复定义
+static const three_point_template_t three_point_templates[] = {
+
+    // 向下倾斜：roll 0° -> -25° -> -50°
+    {
+        .point1 = {0.0f, 0.0f, 25.0f, "起始点"},   // 增大容差
+        .point2 = {-25.0f, 0.0f, 20.0f, "中间点"}, // 增大容差
+        .point3 = {-50.0f, 0.0f, 20.0f, "结束点"}, // 增大容差
+        .max_duration_ms = 1000,                   // 保留但仅用于显示
+        .action_id = ACTION_TILT_DOWN,
+        .action_name = "向下倾斜"},
+
+    // 向上倾斜：roll -50° -> -25° -> 0°
+    {
+        .point1 = {-50.0f, 0.0f, 25.0f, "起始点"},
+        .point2 = {-25.0f, 0.0f, 20.0f, "中间点"},
+        .point3 = {0.0f, 0.0f, 20.0f, "结束点"},
+        .max_duration_ms = 1000,
+        .action_id = ACTION_TILT_UP,
+        .action_name = "向上倾斜"},
+
+    // 举手放下：roll -50° -> -25° -> 0°
+    {
+        .point1 = {40.0f, -80.0f, 25.0f, "起始点"},
+        .point2 = {20.0f, -40.0f, 20.0f, "中间点"},
+        .point3 = {0.0f, 0.0f, 20.0f, "结束点"},
+        .max_duration_ms = 1000,
+        .action_id = HAND_DOWN,
+        .action_name = "举手放下"},
+
+    // 举手：roll -50° -> -25° -> 0°
+    {
+        .point1 = {10.0f, -10.0f, 25.0f, "起始点"},
+        .point2 = {20.0f, -40.0f, 20.0f, "中间点"},
+        .point3 = {40.0f, -80.0f, 20.0f, "结束点"},
+        .max_duration_ms = 1000,
+        .action_id = HAND_UP,
+        .action_name = "举手"},
+
+    // 平上举：roll -50° -> -25° -> 0°
+    {
+        .point1 = {10.0f, -60.0f, 25.0f, "起始点"},
+        .point2 = {40.0f, -60.0f, 20.0f, "中间点"},
+        .point3 = {80.0f, -60.0f, 20.0f, "结束点"},
+        .max_duration_ms = 1000,
+        .action_id = PING_SHANGJU,
+        .action_name = "平上举"},
+
+};
+
+// 检测状态
+typedef enum
+{
+    POINT_STATE_IDLE,     // 空闲，等待第一个点
+    POINT_STATE_POINT1,   // 已检测到第一个点
+    POINT_STATE_POINT2,   // 已检测到第二个点
+    POINT_STATE_COMPLETED // 动作完成
+} point_state_t;
+
+#define NUM_TEMPLATES (sizeof(three_point_templates) / sizeof(three_point_templates[0]))
+
+// 模板的四元数形式, 由上面的 roll/pitch 表转换而来, 也可用 three_point_set_orientation 直接定义
+static quat_point_t template_orient[NUM_TEMPLATES][3];
+static bool template_orient_ready = false;
+
+// 旧表的容差是加权欧拉距离 sqrt(droll^2 + 0.5*dpitch^2) 下的度数, 而测地距离在 pitch 较大处
+// 比欧拉距离小得多 (平上举相邻点欧拉距离30°, 测地距离只有约17°); 直接照搬会让第1点中心落进第2点.
+// 按相邻两点"测地距离/欧拉距离"的比例缩放容差, 保持容差与点间距的比例不变;
+// 中间点取前后两段中较小的比例
+static float euler_distance(const feature_point_t *a, const feature_point_t *b)
+{
+    float roll_diff = a->roll - b->roll;
+    float pitch_diff = a->pitch - b->pitch;
+    return sqrtf(roll_diff * roll_diff + pitch_diff * pitch_diff * 0.5f);
+}
+
+static float geodesic_scale(const feature_point_t *a, const feature_point_t *b)
+{
+    float euler = euler_distance(a, b);
+    if (euler < 1e-3f)
+    {
+        return 1.0f;
+    }
+    quat_t qa = quat_from_roll_pitch(a->roll, a->pitch);
+    quat_t qb = quat_from_roll_pitch(b->roll, b->pitch);
+    return quat_geodesic_deg(&qa, &qb) / euler;
+}
+
+static void build_template_orient(void)
+{
+    for (int i = 0; i < (int)NUM_TEMPLATES; i++)
+    {
+        const feature_point_t *points[3] = {&three_point_templates[i].point1,
+                                            &three_point_templates[i].point2,
+                                            &three_point_templates[i].point3};
+        float scale12 = geodesic_scale(points[0], points[1]);
+        float scale23 = geodesic_scale(points[1], points[2]);
+        float scales[3] = {scale12, fminf(scale12, scale23), scale23};
+        for (int j = 0; j < 3; j++)
+        {
+            template_orient[i][j] = quat_point_from_roll_pitch(points[j]->roll, points[j]->pitch,
+                                                               points[j]->tolerance * scales[j]);
+        }
+    }
+    template_orient_ready = true;
+}
+
+// 三点检测器
+typedef struct
+{
+    point_state_t state;
+    int current_template;    // 当前匹配的模板索引
+    uint32_t start_time;     // 动作开始时间
+    uint32_t point1_time;    // 第一个点时间
+    uint32_t point2_time;    // 第二个点时间
+    uint32_t point3_time;    // 第三个点时间
+    uint32_t last_detection; // 上次检测完成时间
+    bool wait_rest;          // 提前起音取消后, 等手停下再匹配起始点
+    bool resting;            // 角速度已低于静止阈值
+    uint32_t rest_since;     // 开始静止的时间
+} three_point_detector_t;
+
+static three_point_detector_t detector = {
+    .state = POINT_STATE_IDLE,
+    .current_template = -1,
+    .start_time = 0,
+    .point1_time = 0,
+    .point2_time = 0,
+    .point3_time = 0,
+    .last_detection = 0,
+    .wait_rest = false,
+    .resting = false,
+    .rest_since = 0};
+
+// 取消后重新匹配的静止判据: 模板相邻点的容差区域互相重叠 (向上倾斜第1、2点在 -45°~-25° 重叠),
+// 折返途中立即重新匹配会把几度的回摆识别成反向动作
+#define REARM_REST_DPS 20.0f // 角速度低于此值视为静止 (度/秒)
+#define REARM_REST_MS 30     // 持续静止的时间
+
+static bool at_rest(const imu_euler_t *euler, uint32_t current_time)
+{
+    float w2 = euler->gyro_x * euler->gyro_x + euler->gyro_y * euler->gyro_y + euler->gyro_z * euler->gyro_z;
+    if (w2 > REARM_REST_DPS * REARM_REST_DPS)
+    {
+        detector.resting = false;
+        return false;
+    }
+    if (!detector.resting)
+    {
+        detector.resting = true;
+        detector.rest_since = current_time;
+    }
+    return current_time - detector.rest_since >= REARM_REST_MS;
+}
+
+// 点匹配函数 - 四元数测地距离, 只做一次点积比较
+// point_index: 0~2 对应第1~3点
+bool matches_point(const imu_euler_t *euler, int template_index, int point_index)
+{
+    if (!template_orient_ready)
+    {
+        build_template_orient();
+    }
+    return quat_point_matches(&euler->tilt, &template_orient[template_index][point_index]);
+}
+
+bool three_point_get_orientation(simple_action_t action, int point_index, quat_point_t *point)
+{
+    if (point == NULL || point_index < 0 || point_index > 2)
+    {
+        return false;
+    }
+    if (!template_orient_ready)
+    {
+        build_template_orient();
+    }
+
+    for (int i = 0; i < (int)NUM_TEMPLATES; i++)
+    {
+        if (three_point_templates[i].action_id == action)
+        {
+            *point = template_orient[i][point_index];
+            return true;
+        }
+    }
+    return false;
+}
+
+bool three_point_set_orientation(simple_action_t action, int point_index, const quat_t *q, float tolerance_deg)
+{
+    if (q == NULL || point_index < 0 || point_index > 2)
+    {
+        return false;
+    }
+    if (!template_orient_ready)
+    {
+        build_template_orient();
+    }
+
+    for (int i = 0; i < (int)NUM_TEMPLATES; i++)
+    {
+        if (three_point_templates[i].action_id == action)
+        {
+            template_orient[i][point_index].q = *q;
+            template_orient[i][point_index].cos_half_tol = cosf(tolerance_deg * 0.5f * 0.017453f);
+            return true;
+        }
+    }
+    return false;
+}
+
+// 三点检测主函数
+simple_action_t detect_three_point_action(const imu_euler_t *euler, uint32_t *execution_time, note_duration_t *note_type)
+{
+    uint32_t current_time = now_ms();
+    const int num_templates = NUM_TEMPLATES;
+
+    switch (detector.state)
+    {
+    case POINT_STATE_IDLE:
+        if (detector.wait_rest)
+        {
+            if (!at_rest(euler, current_time))
+            {
+                break;
+            }
+            detector.wait_rest = false;
+        }
+
+        // 寻找第一个点的匹配
+        for (int i = 0; i < num_templates; i++)
+        {
+            if (matches_point(euler, i, 0))
+            {
+                detector.state = POINT_STATE_POINT1;
+                detector.current_template = i;
+                detector.start_time = current_time;
+                detector.point1_time = current_time;
+
+                printf("🎯 第1点: %s - %s (R=%.1f°)\n",
+                       three_point_templates[i].action_name,
+                       three_point_templates[i].point1.name,
+                       euler->roll);
+                break;
+            }
+        }
+        break;
+
+    case POINT_STATE_POINT1:
+    {
+        const three_point_template_t *action_template = &three_point_templates[detector.current_template];
+
+        // 检查是否仍在第一个点附近
+        bool still_at_point1 = matches_point(euler, detector.current_template, 0);
+
+        // 如果离开了当前第一个点，检查是否匹配其他第一个点
+        if (!still_at_point1)
+        {
+            // 先检查是否到达当前模板的第二个点
+            if (matches_point(euler, detector.current_template, 1))
+            {
+                detector.state = POINT_STATE_POINT2;
+                detector.point2_time = current_time; // 从第二个点开始计时！
+
+                printf("🎯 第2点: %s (R=%.1f°) - 开始计时\n",
+                       action_template->point2.name,
+                       euler->roll);
+                break;
+            }
+
+            // 如果没到第二个点，检查是否匹配其他模板的第一个点
+            bool found_new_start = false;
+            for (int i = 0; i < num_templates; i++)
+            {
+                if (matches_point(euler, i, 0))
+                {
+                    // 切换到新的第一个点
+                    detector.current_template = i;
+                    detector.start_time = current_time;
+                    detector.point1_time = current_time;
+
+                    printf("🔄 切换到新起点: %s - %s (R=%.1f°)\n",
+                           three_point_templates[i].action_name,
+                           three_point_templates[i].point1.name,
+                           euler->roll);
+                    found_new_start = true;
+                    break;
+                }
+            }
+
+            // 如果既不在任何第一个点，也没到第二个点，重置为空闲
+            if (!found_new_start)
+            {
+                printf("🔄 离开第1点且无新匹配，重置\n");
+                detector.state = POINT_STATE_IDLE;
+            }
+        }
+        else
+        {
+            // 仍在第一个点，检查第二个点
+            if (matches_point(euler, detector.current_template, 1))
+            {
+                detector.state = POINT_STATE_POINT2;
+                detector.point2_time = current_time; // 从第二个点开始计时！
+
+                printf("🎯 第2点: %s (R=%.1f°) - 开始计时\n",
+                       action_template->point2.name,
+                       euler->roll);
+            }
+        }
+
+        // 安全超时机制（防止卡死，但时间延长到10秒）
+        uint32_t elapsed_from_start = current_time - detector.start_time;
+        if (elapsed_from_start > 10000)
+        {
+            printf("⏰ 安全超时10秒，重置\n");
+            detector.state = POINT_STATE_IDLE;
+        }
+        break;
+    }
+
+    case POINT_STATE_POINT2:
+    {
+        const three_point_template_t *action_template = &three_point_templates[detector.current_template];
+
+        // 从第二个点开始计算超时时间（1秒）
+        uint32_t elapsed_from_point2 = current_time - detector.point2_time;
+
+        // 超时检查：从第二个点开始1秒内必须完成
+        if (elapsed_from_point2 > 1000)
+        {
+            printf("⏰ 从第2点超时1秒，重置\n");
+            detector.state = POINT_STATE_IDLE;
+            break;
+        }
+
+        // 检查第三个点
+        if (matches_point(euler, detector.current_template, 2))
+        {
+            detector.point3_time = current_time;
+
+            // 计算从第二个点到第三个点的时间作为执行时间
+            uint32_t execution_duration = current_time - detector.point2_time;
+            uint32_t total_time = current_time - detector.start_time;
+
+            // 动作完成！
+            *execution_time = execution_duration;
+            *note_type = match_note_duration(execution_duration);
+
+            printf("🎯 第3点: %s (R=%.1f°)\n",
+                   action_template->point3.name, euler->roll);
+            printf("✅ %s 完成! 执行时间: %lums (总时间: %lums)\n",
+                   action_template->action_name, execution_duration, total_time);
+
+            detector.state = POINT_STATE_COMPLETED;
+            detector.last_detection = current_time;
+
+            return action_template->action_id;
+        }
+        break;
+    }
+
+    case POINT_STATE_COMPLETED:
+        // 立即重置，支持连续检测
+        detector.state = POINT_STATE_IDLE;
+        printf("🔄 立即准备下一个动作检测\n");
+        break;
+    }
+
+    return ACTION_NONE;
+}
+
+// 改进版显示状态函数，显示动态切换信息
+void print_three_point_status(const imu_euler_t *euler)
+{
+    printf("当前姿态: Roll=%.1f° Pitch=%.1f°\n", euler->roll, euler->pitch);
+
+    const char *state_names[] = {"空闲", "等待第2点", "等待第3点", "已完成"};
+    printf("检测状态: %s\n", state_names[detector.state]);
+
+    if (detector.current_template >= 0)
+    {
+        const three_point_template_t *action_template = &three_point_templates[detector.current_template];
+        printf("当前动作: %s\n", action_template->action_name);
+
+        if (detector.state == POINT_STATE_POINT1)
+        {
+            uint32_t elapsed = now_ms() - detector.start_time;
+            bool at_point1 = matches_point(euler, detector.current_template, 0);
+
+            printf("第1点状态: %s (已用时: %lums)\n",
+                   at_point1 ? "在点上" : "已离开", elapsed);
+            printf("目标: 第2点 Roll=%.1f° (容差±%.1f°)\n",
+                   action_template->point2.roll, action_template->point2.tolerance);
+        }
+        else if (detector.state == POINT_STATE_POINT2)
+        {
+            uint32_t elapsed_from_point2 = now_ms() - detector.point2_time;
+            uint32_t remaining = elapsed_from_point2 < 1000 ? 1000 - elapsed_from_point2 : 0;
+
+            printf("第2点已用时: %lums / 1000ms (剩余: %lums)\n",
+                   elapsed_from_point2, remaining);
+            printf("目标: 第3点 Roll=%.1f° (容差±%.1f°)\n",
+                   action_template->point3.roll, action_template->point3.tolerance);
+        }
+    }
+
+    // 显示当前位置匹配情况
+    const int num_templates = NUM_TEMPLATES;
+    int match_count = 0;
+    for (int i = 0; i < num_templates; i++)
+    {
+        const three_point_template_t *tmpl = &three_point_templates[i];
+
+        if (matches_point(euler, i, 0))
+        {
+            printf("可启动: %s (第1点匹配)\n", tmpl->action_name);
+            match_count++;
+        }
+    }
+
+    if (match_count == 0 && detector.state == POINT_STATE_IDLE)
+    {
+        printf("当前位置无匹配的起始点\n");
+    }
+}
+
+// ============= 预测触发 (提前起音) =============
+
+// 预测窗口约为运动时加速度低通 (alpha=0.7@20Hz, 时间常数约40ms) 的滞后, 即第3点判定晚于实际动作的时间;
+// 主循环由 imu_task 按批唤醒, 轮询只再增加一批 (10ms)
+#define PREDICT_HORIZON_MS 40
+#define PREDICT_PROB_THRESHOLD 0.6f  // 完成概率超过此值即提前起音
+#define PREDICT_BASELINE_MS 20       // 远离判定的时间基线, 采样率高时避免放大噪声
+#define PREDICT_RECEDE_EPS 0.005f    // 到第3点的距离增大超过此值(弧度, 约0.3°)记为一次远离
+#define PREDICT_RECEDE_STEPS 2       // 连续远离的基线步数, 达到即取消
+#define PREDICT_CORRIDOR_SCALE 1.5f  // 走廊半宽 = 第3点容差 × 此值
+
+// 预测器状态与统计
+typedef struct
+{
+    bool speculating;       // 已提前起音, 等待确认或取消
+    simple_action_t action; // 提前起音的动作
+    uint32_t onset_time;    // 提前起音时间
+    bool have_prev;         // 是否有上一步 (进入第2点后的第一个样本时为 false)
+    float entry_dist3;      // 进入第2点时到第3点的近似测地距离(弧度), 进度从这里算起
+    float prev_dist3;       // 上一步到第3点的近似测地距离(弧度)
+    uint32_t prev_time;     // 上一步时间
+    uint8_t recede_steps;   // 连续远离第3点的步数
+
+    uint32_t onsets;        // 提前起音次数
+    uint32_t confirmed;     // 被确认次数
+    uint32_t cancelled;     // 被取消次数
+    uint32_t unpredicted;   // 未能提前、按原方式触发次数
+    uint32_t saved_ms_sum;  // 累计节省的延迟
+} note_predictor_t;
+
+static note_predictor_t predictor = {};
+
+// 容差对应的近似测地距离, 与 quat_approx_angle 同一度量
+static float point_radius(const quat_point_t *point)
+{
+    return 2.0f * sqrtf(2.0f * (1.0f - point->cos_half_tol));
+}
+
+// 每隔一个基线比较一次到第3点的距离, 记录连续远离的步数
+static void track_progress(float dist3, uint32_t current_time)
+{
+    if (!predictor.have_prev)
+    {
+        predictor.have_prev = true;
+        predictor.entry_dist3 = dist3;
+        predictor.prev_dist3 = dist3;
+        predictor.prev_time = current_time;
+        predictor.recede_steps = 0;
+        return;
+    }
+
+    if (current_time - predictor.prev_time < PREDICT_BASELINE_MS)
+    {
+        return;
+    }
+
+    if (dist3 > predictor.prev_dist3 + PREDICT_RECEDE_EPS)
+    {
+        predictor.recede_steps++;
+    }
+    else
+    {
+        predictor.recede_steps = 0;
+    }
+
+    predictor.prev_dist3 = dist3;
+    predictor.prev_time = current_time;
+}
+
+// 陀螺仪给出的朝第3点的角速度(弧度/ms), 负值为远离
+// 重力方向 g 在机体系中的变化 dg/dt = g × ω, 朝 g3 转动的分量为 ω·(g3 × g)/|g3 × g|
+// 倾斜四元数之间的测地距离与重力方向夹角在模板尺度上近似相等
+static float closing_rate(const imu_euler_t *euler, const quat_point_t *p3)
+{
+    float gx, gy, gz, tx, ty, tz;
+    quat_to_gravity(&euler->tilt, &gx, &gy, &gz);
+    quat_to_gravity(&p3->q, &tx, &ty, &tz);
+
+    float ax = ty * gz - tz * gy;
+    float ay = tz * gx - tx * gz;
+    float az = tx * gy - ty * gx;
+    float n = sqrtf(ax * ax + ay * ay + az * az);
+    if (n < 1e-4f)
+    {
+        return 0.0f;
+    }
+
+    float dps = (euler->gyro_x * ax + euler->gyro_y * ay + euler->gyro_z * az) / n;
+    return dps * 0.017453f / 1000.0f;
+}
+
+// 是否仍在第2点到第3点的走廊内: 到线段 p2-p3 的距离不超过走廊半宽
+// 距离都很小, 按平面三角形近似
+static bool in_corridor(const imu_euler_t *euler)
+{
+    const quat_point_t *p2 = &template_orient[detector.current_template][1];
+    const quat_point_t *p3 = &template_orient[detector.current_template][2];
+
+    float a = quat_approx_angle(&euler->tilt, &p2->q);
+    float b = quat_approx_angle(&euler->tilt, &p3->q);
+    float c = quat_approx_angle(&p2->q, &p3->q);
+
+    float dist;
+    if (c < 1e-6f || b * b >= a * a + c * c)
+    {
+        dist = a; // 在第2点之后方
+    }
+    else if (a * a >= b * b + c * c)
+    {
+        dist = b; // 越过第3点
+    }
+    else
+    {
+        float along = (a * a + c * c - b * b) / (2.0f * c);
+        dist = sqrtf(fmaxf(0.0f, a * a - along * along));
+    }
+
+    return dist <= point_radius(p3) * PREDICT_CORRIDOR_SCALE;
+}
+
+// 估计当前动作的完成概率, 并给出预计到达第3点的剩余时间
+// 进度 = 进入第2点以来走完的比例 (到第3点容差边界), 按陀螺仪角速度外推剩余时间
+static float estimate_completion(float dist3, float rate, uint32_t *eta_ms)
+{
+    const quat_point_t *p3 = &template_orient[detector.current_template][2];
+
+    float tol3 = point_radius(p3);
+    float span = predictor.entry_dist3 - tol3;
+
+    *eta_ms = UINT32_MAX;
+    if (span <= 0.0f || rate <= 0.0f)
+    {
+        return 0.0f;
+    }
+
+    float remaining = fmaxf(0.0f, dist3 - tol3);
+    float progress = fmaxf(0.0f, fminf(1.0f, 1.0f - remaining / span));
+    float eta = remaining / rate;
+
+    *eta_ms = (uint32_t)eta;
+    return eta <= PREDICT_HORIZON_MS ? progress : progress * PREDICT_HORIZON_MS / eta;
+}
+
+// 带预测的三点检测
+// 第2点之后按陀螺仪角速度外推, 完成概率超过阈值时提前起音(ONSET), 之后由第3点确认(CONFIRM);
+// 连续远离第3点、偏离第2→3点走廊或超时则取消(CANCEL)
+note_event_t detect_three_point_predictive(const imu_euler_t *euler, simple_action_t *action, uint32_t *execution_time, note_duration_t *note_type)
+{
+    uint32_t current_time = now_ms();
+    simple_action_t result = detect_three_point_action(euler, execution_time, note_type);
+
+    *action = result;
+
+    if (result != ACTION_NONE)
+    {
+        predictor.have_prev = false;
+
+        if (predictor.speculating)
+        {
+            uint32_t saved = current_time - predictor.onset_time;
+            predictor.speculating = false;
+            predictor.confirmed++;
+            predictor.saved_ms_sum += saved;
+
+            printf("✔️ 提前起音确认: %s (提前%lums)\n", get_action_name(result), saved);
+            return NOTE_EVENT_CONFIRM;
+        }
+
+        predictor.unpredicted++;
+        return NOTE_EVENT_TRIGGER;
+    }
+
+    if (detector.state != POINT_STATE_POINT2)
+    {
+        predictor.have_prev = false;
+
+        if (predictor.speculating)
+        {
+            // 动作未完成, 取消已发出的音符
+            *action = predictor.action;
+            predictor.speculating = false;
+            predictor.cancelled++;
+            detector.wait_rest = true;
+
+            printf("❌ 提前起音取消: %s (超时)\n", get_action_name(predictor.action));
+            return NOTE_EVENT_CANCEL;
+        }
+        return NOTE_EVENT_NONE;
+    }
+
+    const quat_point_t *p3 = &template_orient[detector.current_template][2];
+    float dist3 = quat_approx_angle(&euler->tilt, &p3->q);
+    track_progress(dist3, current_time);
+
+    if (predictor.speculating)
+    {
+        bool receding = predictor.recede_steps >= PREDICT_RECEDE_STEPS;
+        if (receding || !in_corridor(euler))
+        {
+            // 偏离预测的路径: 立即释放, 并放弃本次动作, 不等1秒超时
+            *action = predictor.action;
+            predictor.speculating = false;
+            predictor.have_prev = false;
+            predictor.cancelled++;
+            detector.state = POINT_STATE_IDLE;
+            detector.wait_rest = true;
+
+            printf("❌ 提前起音取消: %s (%s)\n", get_action_name(predictor.action),
+                   receding ? "远离第3点" : "偏离路径");
+            return NOTE_EVENT_CANCEL;
+        }
+        return NOTE_EVENT_NONE;
+    }
+
+    uint32_t eta_ms;
+    float prob = estimate_completion(dist3, closing_rate(euler, p3), &eta_ms);
+    if (prob < PREDICT_PROB_THRESHOLD)
+    {
+        return NOTE_EVENT_NONE;
+    }
+
+    const three_point_template_t *action_template = &three_point_templates[detector.current_template];
+
+    predictor.speculating = true;
+    predictor.action = action_template->action_id;
+    predictor.onset_time = current_time;
+    predictor.onsets++;
+
+    // 用预计的总执行时间匹配音符时长, 确认时会给出实际值
+    *action = action_template->action_id;
+    *execution_time = current_time - detector.point2_time + eta_ms;
+    *note_type = match_note_duration(*execution_time);
+
+    printf("⚡ 提前起音: %s (完成概率%.2f, 预计%lums后到达第3点)\n",
+           action_template->action_name, prob, eta_ms);
+    return NOTE_EVENT_ONSET;
+}
+
+// 显示预测统计: 准确率与节省的延迟
+void print_prediction_stats(void)
+{
+    uint32_t resolved = predictor.confirmed + predictor.cancelled;
+
+    printf("预测统计: 提前起音%lu次 确认%lu次 取消%lu次 未预测%lu次\n",
+           predictor.onsets, predictor.confirmed, predictor.cancelled, predictor.unpredicted);
+    if (resolved > 0)
+    {
+        printf("预测准确率: %.1f%%\n", 100.0f * predictor.confirmed / resolved);
+    }
+    if (predictor.confirmed > 0)
+    {
+        printf("平均节省延迟: %lums\n", predictor.saved_ms_sum / predictor.confirmed);
+    }
+}
+
+// 重置三点检测器, 同时放弃未确认的提前起音 (统计保留)
+void reset_three_point_detector(void)
+{
+    detector.state = POINT_STATE_IDLE;
+    detector.current_template = -1;
+    detector.last_detection = 0;
+    detector.wait_rest = false;
+    predictor.speculating = false;
+    predictor.have_prev = false;
+    printf("三点检测器已重置\n");
+}
+
+size_t three_point_static_bytes(void)
+{
+    return sizeof(detector) + sizeof(template_orient) + sizeof(predictor);
+}
@@ -0,0 +1,216 @@
+#include "bmi270_fifo.h"
+#include <string.h>
+
+const bmi270_axis_map_t bmi270_axis_identity = {{0, 1, 2}, {1, 1, 1}};
+
+// AtomS3R 的 BMI270 贴在板子背面, 绕Y轴转了180°: X、Z 取反
+const bmi270_axis_map_t bmi270_axis_atoms3r = {{0, 1, 2}, {-1, 1, -1}};
+
+static int16_t read_le16(const uint8_t *p)
+{
+    return (int16_t)((uint16_t)p[0] | ((uint16_t)p[1] << 8));
+}
+
+// 读取一个三轴向量并映射到板级坐标
+static void read_axes(const uint8_t *p, float scale, const bmi270_axis_map_t *map, float *out)
+{
+    float raw[3] = {read_le16(p) * scale, read_le16(p + 2) * scale, read_le16(p + 4) * scale};
+    for (int i = 0; i < 3; i++)
+    {
+        out[i] = map->sign[i] * raw[map->src[i]];
+    }
+}
+
+// ============= FIFO解析 =============
+
+int bmi270_fifo_parse(const uint8_t *buf, size_t len, float acc_scale, float gyr_scale, const bmi270_axis_map_t *map,
+                      imu_data_t *last, imu_data_t *out, int max_samples, bmi270_fifo_parse_info_t *info)
+{
+    memset(info, 0, sizeof(*info));
+
+    size_t i = 0;
+    while (i < len)
+    {
+        uint8_t header = buf[i];
+        uint8_t mode = header & 0xC0;
+        uint8_t parm = (header >> 2) & 0x0F;
+
+        if (header == BMI270_FIFO_HEADER_END)
+        {
+            info->reached_end = true;
+            break;
+        }
+
+        if (mode == 0x40)
+        {
+            // 控制帧
+            size_t payload;
+            switch (header & 0xFC)
+            {
+            case BMI270_FIFO_HEADER_SKIP:
+                payload = 1;
+                break;
+            case BMI270_FIFO_HEADER_TIME:
+                payload = 3;
+                break;
+            case BMI270_FIFO_HEADER_CONFIG:
+                payload = 4;
+                break;
+            default:
+                return info->samples; // 无法识别, 停止解析
+            }
+
+            if (i + 1 + payload > len)
+            {
+                break; // 帧不完整
+            }
+            if ((header & 0xFC) == BMI270_FIFO_HEADER_SKIP)
+            {
+                info->skipped += buf[i + 1];
+            }
+            i += 1 + payload;
+            info->consumed = i;
+            continue;
+        }
+
+        if (mode != 0x80 || parm == 0 || (parm & 0x08))
+        {
+            break; // 无法识别, 停止解析
+        }
+
+        // 数据帧: parm 位0 加速度, 位1 陀螺仪, 位2 aux; 数据顺序 aux, 陀螺仪, 加速度
+        bool has_acc = parm & 0x01;
+        bool has_gyr = parm & 0x02;
+        bool has_aux = parm & 0x04;
+        size_t payload = (has_aux ? 8 : 0) + (has_gyr ? 6 : 0) + (has_acc ? 6 : 0);
+
+        if (i + 1 + payload > len || info->samples >= max_samples)
+        {
+            break; // 帧不完整或输出已满
+        }
+
+        const uint8_t *p = &buf[i + 1];
+        if (has_aux)
+        {
+            p += 8;
+        }
+        if (has_gyr)
+        {
+            read_axes(p, gyr_scale, map, &last->gyro_x);
+            p += 6;
+        }
+        if (has_acc)
+        {
+            read_axes(p, acc_scale, map, &last->accel_x);
+        }
+
+        out[info->samples++] = *last;
+        i += 1 + payload;
+        info->consumed = i;
+    }
+
+    return info->samples;
+}
+
+// ============= FIFO读取 =============
+
+static int write_reg(bmi270_fifo_t *fifo, uint8_t reg, uint8_t value)
+{
+    return fifo->ops->write(fifo->ops->ctx, fifo->addr, reg, &value, 1);
+}
+
+int bmi270_fifo_init(bmi270_fifo_t *fifo, const imubus_ops_t *ops, uint8_t addr, uint8_t odr, uint32_t wakeup_ms,
+                     const bmi270_axis_map_t *map)
+{
+    memset(fifo, 0, sizeof(*fifo));
+    fifo->ops = ops;
+    fifo->addr = addr;
+    fifo->axis_map = *map;
+    fifo->acc_scale = 8.0f / 32768.0f;    // ±8g
+    fifo->gyr_scale = 2000.0f / 32768.0f; // ±2000dps
+
+    // 每次唤醒预计的帧数, 突发读取按两倍余量
+    uint32_t odr_hz = 400u << (odr - BMI270_ODR_400HZ);
+    size_t frames = odr_hz * wakeup_ms / 1000;
+    fifo->burst_len = (frames * 2 + 1) * BMI270_FIFO_FRAME_ACC_GYR;
+    if (fifo->burst_len > BMI270_FIFO_BUF_SIZE)
+    {
+        fifo->burst_len = BMI270_FIFO_BUF_SIZE;
+    }
+
+    // 保留 M5Unified 已打开的 aux (BMM150), 再打开加速度和陀螺仪
+    uint8_t pwr_ctrl = 0;
+    if (ops->read(ops->ctx, addr, BMI270_REG_PWR_CTRL, &pwr_ctrl, 1) != 0)
+    {
+        return -1;
+    }
+
+    int ret = 0;
+    ret |= write_reg(fifo, BMI270_REG_PWR_CTRL, pwr_ctrl | 0x06);
+    ret |= write_reg(fifo, BMI270_REG_ACC_CONF, 0xA0 | odr);  // filter_perf, 正常带宽
+    ret |= write_reg(fifo, BMI270_REG_ACC_RANGE, 0x02);       // ±8g
+    ret |= write_reg(fifo, BMI270_REG_GYR_CONF, 0xE0 | odr);  // filter_perf, noise_perf, 正常带宽
+    ret |= write_reg(fifo, BMI270_REG_GYR_RANGE, 0x00);       // ±2000dps
+    ret |= write_reg(fifo, BMI270_REG_FIFO_CONFIG_0, 0x00);   // 流模式, 不附带传感器时间
+    ret |= write_reg(fifo, BMI270_REG_FIFO_CONFIG_1, 0xD0);   // 陀螺仪 + 加速度, 头模式
+    ret |= write_reg(fifo, BMI270_REG_CMD, BMI270_CMD_FIFO_FLUSH);
+
+    return ret == 0 ? 0 : -1;
+}
+
+int bmi270_fifo_drain(bmi270_fifo_t *fifo, imu_data_t *out, int max_samples)
+{
+    const imubus_ops_t *ops = fifo->ops;
+    size_t len = fifo->burst_len;
+    int total = 0;
+
+    // 正常情况下一次突发读取就会读到读空标记; 积压时最多再按FIFO长度读两次
+    // 帧只读了一部分时, BMI270 会在下次读取时重发该帧
+    for (int pass = 0; pass < 3 && total < max_samples; pass++)
+    {
+        // FIFO读取是破坏性的, 不读超过输出能容纳的帧数
+        size_t room = (size_t)(max_samples - total) * BMI270_FIFO_FRAME_ACC_GYR + 1;
+        if (len > room)
+        {
+            len = room;
+        }
+        if (pass > 0)
+        {
+            fifo->backlog++;
+        }
+
+        if (ops->read(ops->ctx, fifo->addr, BMI270_REG_FIFO_DATA, fifo->buf, len) != 0)
+        {
+            return total > 0 ? total : -1;
+        }
+        fifo->bursts++;
+
+        bmi270_fifo_parse_info_t info;
+        total += bmi270_fifo_parse(fifo->buf, len, fifo->acc_scale, fifo->gyr_scale, &fifo->axis_map,
+                                   &fifo->last, &out[total], max_samples - total, &info);
+        fifo->frames += info.samples;
+        fifo->skipped += info.skipped;
+
+        if (info.reached_end)
+        {
+            break;
+        }
+
+        uint8_t length[2];
+        if (ops->read(ops->ctx, fifo->addr, BMI270_REG_FIFO_LENGTH_0, length, 2) != 0)
+        {
+            break;
+        }
+        len = ((size_t)length[0] | ((size_t)(length[1] & 0x3F) << 8));
+        if (len == 0)
+        {
+            break;
+        }
+        if (len > BMI270_FIFO_BUF_SIZE)
+        {
+            len = BMI270_FIFO_BUF_SIZE;
+        }
+    }
+
+    return total;
+}
@@ -0,0 +1,113 @@
+#ifndef BMI270_FIFO_H
+#define BMI270_FIFO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "imu/imu.h"
+#include "imubus/imubus.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define BMI270_ADDR 0x68 // AtomS3R 内部 BMI270
+
+// 寄存器
+#define BMI270_REG_FIFO_LENGTH_0 0x24
+#define BMI270_REG_FIFO_DATA 0x26
+#define BMI270_REG_ACC_CONF 0x40
+#define BMI270_REG_ACC_RANGE 0x41
+#define BMI270_REG_GYR_CONF 0x42
+#define BMI270_REG_GYR_RANGE 0x43
+#define BMI270_REG_FIFO_CONFIG_0 0x48
+#define BMI270_REG_FIFO_CONFIG_1 0x49
+#define BMI270_REG_PWR_CTRL 0x7D
+#define BMI270_REG_CMD 0x7E
+
+#define BMI270_CMD_FIFO_FLUSH 0xB0
+
+// 输出数据率
+#define BMI270_ODR_400HZ 0x0A
+#define BMI270_ODR_800HZ 0x0B
+#define BMI270_ODR_1600HZ 0x0C
+
+// 头模式FIFO帧
+#define BMI270_FIFO_HEADER_END 0x80      // 读空后返回
+#define BMI270_FIFO_HEADER_SKIP 0x40     // 溢出丢帧, 1字节丢帧数
+#define BMI270_FIFO_HEADER_TIME 0x44     // 传感器时间, 3字节
+#define BMI270_FIFO_HEADER_CONFIG 0x48   // 输入配置变化, 4字节
+#define BMI270_FIFO_FRAME_ACC_GYR 13     // 1字节头 + 6字节陀螺仪 + 6字节加速度
+
+#define BMI270_FIFO_BUF_SIZE 256 // 单次突发读取最大字节数
+
+    // 芯片坐标轴到板级坐标轴的映射: out[i] = sign[i] * in[src[i]], 加速度和陀螺仪相同
+    typedef struct
+    {
+        uint8_t src[3];
+        int8_t sign[3];
+    } bmi270_axis_map_t;
+
+    extern const bmi270_axis_map_t bmi270_axis_identity;
+    extern const bmi270_axis_map_t bmi270_axis_atoms3r; // 与 M5Unified 对 AtomS3R 内部 BMI270 的轴序一致
+
+    // 单次解析结果
+    typedef struct
+    {
+        int samples;         // 解析出的样本数
+        size_t consumed;     // 已解析的字节数
+        bool reached_end;    // 遇到读空标记, FIFO已取空
+        uint32_t skipped;    // 溢出丢失的帧数
+    } bmi270_fifo_parse_info_t;
+
+    // FIFO读取上下文
+    typedef struct
+    {
+        const imubus_ops_t *ops;
+        uint8_t addr;
+        float acc_scale;  // g/LSB
+        float gyr_scale;  // dps/LSB
+        bmi270_axis_map_t axis_map;
+        size_t burst_len; // 每次唤醒突发读取字节数
+        imu_data_t last;  // 只含加速度或陀螺仪的帧用上一帧补齐另一项
+        uint8_t buf[BMI270_FIFO_BUF_SIZE];
+
+        uint32_t bursts;  // 突发读取次数
+        uint32_t frames;  // 解析出的帧数
+        uint32_t skipped; // FIFO溢出丢失的帧数
+        uint32_t backlog; // 一次突发未取空、追加读取的次数
+    } bmi270_fifo_t;
+
+    /**
+     * @brief 解析头模式FIFO数据 (纯函数, 不访问总线)
+     * @param acc_scale 加速度 g/LSB
+     * @param gyr_scale 陀螺仪 dps/LSB
+     * @param map 坐标轴映射
+     * @param last 输入上一帧, 输出最后一帧
+     * @return 样本数
+     */
+    int bmi270_fifo_parse(const uint8_t *buf, size_t len, float acc_scale, float gyr_scale, const bmi270_axis_map_t *map,
+                          imu_data_t *last, imu_data_t *out, int max_samples, bmi270_fifo_parse_info_t *info);
+
+    /**
+     * @brief 配置加速度/陀螺仪ODR和量程, 打开头模式FIFO并清空
+     * @param odr BMI270_ODR_*
+     * @param wakeup_ms 读取周期, 用于计算每次突发读取长度
+     * @param map 板级坐标轴映射
+     * @return 0 成功
+     */
+    int bmi270_fifo_init(bmi270_fifo_t *fifo, const imubus_ops_t *ops, uint8_t addr, uint8_t odr, uint32_t wakeup_ms,
+                         const bmi270_axis_map_t *map);
+
+    /**
+     * @brief 一次突发读取并解析FIFO; 若未取空, 按FIFO长度追加读取
+     * @return 样本数, 失败返回 -1
+     */
+    int bmi270_fifo_drain(bmi270_fifo_t *fifo, imu_data_t *out, int max_samples);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // BMI270_FIFO_H
\ No newline at end of file
@@ -0,0 +1,140 @@
+#include "imubus.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "memstat/memstat.h"
+#include <stdio.h>
+#include <string.h>
+
+#define IMUBUS_QUEUE_LEN 8
+
+typedef enum
+{
+    IMUBUS_OP_READ,
+    IMUBUS_OP_WRITE
+} imubus_op_t;
+
+// 排队的请求, 放在请求任务的栈上, 由所有者执行后通知
+typedef struct
+{
+    imubus_op_t op;
+    uint8_t dev_addr;
+    uint8_t reg;
+    uint8_t *buf;
+    size_t len;
+    int result;
+    TaskHandle_t requester;
+} imubus_request_t;
+
+static const imubus_ops_t *bus_ops = NULL;
+static TaskHandle_t bus_owner = NULL;
+static QueueHandle_t request_queue = NULL;
+static StaticQueue_t request_queue_buf;
+static uint8_t request_queue_storage[IMUBUS_QUEUE_LEN * sizeof(imubus_request_t *)];
+static imubus_stats_t bus_stats;
+
+// ============= 总线仲裁 =============
+
+static void execute(imubus_request_t *req)
+{
+    if (req->op == IMUBUS_OP_READ)
+    {
+        req->result = bus_ops->read(bus_ops->ctx, req->dev_addr, req->reg, req->buf, req->len);
+    }
+    else
+    {
+        req->result = bus_ops->write(bus_ops->ctx, req->dev_addr, req->reg, req->buf, req->len);
+    }
+
+    bus_stats.transactions++;
+    bus_stats.bytes += req->len;
+    if (req->result != 0)
+    {
+        bus_stats.errors++;
+    }
+}
+
+int imubus_init(const imubus_ops_t *ops)
+{
+    request_queue = xQueueCreateStatic(IMUBUS_QUEUE_LEN, sizeof(imubus_request_t *),
+                                       request_queue_storage, &request_queue_buf);
+    if (request_queue == NULL)
+    {
+        printf("创建总线请求队列失败\r\n");
+        return -1;
+    }
+    memstat_register_pool("I2C请求队列", sizeof(request_queue_storage) + sizeof(request_queue_buf));
+
+    bus_ops = ops;
+    memset(&bus_stats, 0, sizeof(bus_stats));
+    bus_owner = xTaskGetCurrentTaskHandle();
+    return 0;
+}
+
+void imubus_service(void)
+{
+    imubus_request_t *req;
+    while (xQueueReceive(request_queue, &req, 0) == pdTRUE)
+    {
+        execute(req);
+        bus_stats.queued++;
+        xTaskNotifyGive(req->requester);
+    }
+}
+
+static int submit(imubus_request_t *req)
+{
+    if (bus_ops == NULL)
+    {
+        return -1;
+    }
+
+    // 所有者任务内直接执行
+    if (xTaskGetCurrentTaskHandle() == bus_owner)
+    {
+        execute(req);
+        return req->result;
+    }
+
+    req->requester = xTaskGetCurrentTaskHandle();
+    if (xQueueSend(request_queue, &req, portMAX_DELAY) != pdTRUE)
+    {
+        return -1;
+    }
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    return req->result;
+}
+
+int imubus_read(uint8_t dev_addr, uint8_t reg, uint8_t *buf, size_t len)
+{
+    imubus_request_t req = {IMUBUS_OP_READ, dev_addr, reg, buf, len, -1, NULL};
+    return submit(&req);
+}
+
+int imubus_write(uint8_t dev_addr, uint8_t reg, const uint8_t *buf, size_t len)
+{
+    imubus_request_t req = {IMUBUS_OP_WRITE, dev_addr, reg, (uint8_t *)buf, len, -1, NULL};
+    return submit(&req);
+}
+
+static int arbitrated_read(void *ctx, uint8_t dev_addr, uint8_t reg, uint8_t *buf, size_t len)
+{
+    return imubus_read(dev_addr, reg, buf, len);
+}
+
+static int arbitrated_write(void *ctx, uint8_t dev_addr, uint8_t reg, const uint8_t *buf, size_t len)
+{
+    return imubus_write(dev_addr, reg, buf, len);
+}
+
+static const imubus_ops_t arbitrated_ops = {arbitrated_read, arbitrated_write, NULL};
+
+const imubus_ops_t *imubus_arbitrated_ops(void)
+{
+    return &arbitrated_ops;
+}
+
+void imubus_get_stats(imubus_stats_t *stats)
+{
+    *stats = bus_stats;
+}
@@ -0,0 +1,70 @@
+#ifndef IMUBUS_H
+#define IMUBUS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    // 寄存器级总线操作, 目标板上是 M5.In_I2C, 主机上可替换为模拟设备
+    typedef struct
+    {
+        int (*read)(void *ctx, uint8_t dev_addr, uint8_t reg, uint8_t *buf, size_t len);        // 成功返回0
+        int (*write)(void *ctx, uint8_t dev_addr, uint8_t reg, const uint8_t *buf, size_t len); // 成功返回0
+        void *ctx;
+    } imubus_ops_t;
+
+    // 总线统计
+    typedef struct
+    {
+        uint32_t transactions;  // 总线事务数
+        uint32_t bytes;         // 传输字节数
+        uint32_t queued;        // 其他任务提交的请求数
+        uint32_t errors;        // 失败的事务
+    } imubus_stats_t;
+
+    /**
+     * @brief 目标板 I2C 操作 (M5.In_I2C, 400kHz), 见 imubus_m5.cpp
+     */
+    const imubus_ops_t *imubus_m5_ops(void);
+
+    /**
+     * @brief 经过仲裁的总线操作 (内部调用 imubus_read/imubus_write), 供驱动使用
+     */
+    const imubus_ops_t *imubus_arbitrated_ops(void);
+
+    /**
+     * @brief 初始化总线仲裁, 调用任务成为唯一的总线所有者
+     * @param ops 总线操作
+     * @return 0 成功
+     */
+    int imubus_init(const imubus_ops_t *ops);
+
+    /**
+     * @brief 所有者任务在每次唤醒时调用, 依次执行其他任务排队的请求
+     */
+    void imubus_service(void);
+
+    /**
+     * @brief 读寄存器. 所有者任务内直接执行, 其他任务排队等待所有者执行
+     * @return 0 成功
+     */
+    int imubus_read(uint8_t dev_addr, uint8_t reg, uint8_t *buf, size_t len);
+
+    /**
+     * @brief 写寄存器, 规则同 imubus_read
+     * @return 0 成功
+     */
+    int imubus_write(uint8_t dev_addr, uint8_t reg, const uint8_t *buf, size_t len);
+
+    void imubus_get_stats(imubus_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // IMUBUS_H
\ No newline at end of file
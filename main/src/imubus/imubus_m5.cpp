@@ -0,0 +1,22 @@
+// 目标板的寄存器级I2C操作, 与总线仲裁分开, 主机测试用模拟设备替换
+#include "imubus.h"
+#include "M5Unified.h"
+
+#define IMUBUS_I2C_FREQ 400000
+
+static int m5_read(void *ctx, uint8_t dev_addr, uint8_t reg, uint8_t *buf, size_t len)
+{
+    return M5.In_I2C.readRegister(dev_addr, reg, buf, len, IMUBUS_I2C_FREQ) ? 0 : -1;
+}
+
+static int m5_write(void *ctx, uint8_t dev_addr, uint8_t reg, const uint8_t *buf, size_t len)
+{
+    return M5.In_I2C.writeRegister(dev_addr, reg, buf, len, IMUBUS_I2C_FREQ) ? 0 : -1;
+}
+
+static const imubus_ops_t m5_ops = {m5_read, m5_write, NULL};
+
+const imubus_ops_t *imubus_m5_ops(void)
+{
+    return &m5_ops;
+}
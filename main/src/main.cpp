@@ -3,9 +3,50 @@
 #include "M5Unified.h"
 #include "initDevice/initDevice.h"
 #include "imu/imu.h"
+#include "phrase/phrase.h"
+#include "bodynet/bodynet.h"
+#include "bodynet/bodynet_espnow.h"
+#include "spectral/spectral.h"
+#include "filterbank/filterbank.h"
+#include "memstat/memstat.h"
+#include "esp_timer.h"
 #include "nvs_flash.h"
+#include "sdkconfig.h"
+
+// IMU任务栈预算 (字节), 实际用量见栈高水位报告
+#define IMU_TASK_STACK_SIZE 4096
+
+#define STEADY_WARMUP_US 5000000   // 启动后5秒进入稳态, 之后不应再分配堆内存
+#define MEMSTAT_REPORT_US 10000000 // 每10秒报告一次栈/堆高水位
+#define DISPLAY_PERIOD_US 50000    // 屏幕角度显示 20Hz 刷新
+#define IMU_NOTIFY_TIMEOUT_MS 100  // imu_task 停止通知时, 组网收发仍按此间隔进行
 
 TaskHandle_t imu_handle = NULL;
+static StaticTask_t imu_task_buf;
+static StackType_t imu_task_stack[IMU_TASK_STACK_SIZE];
+
+// 多节点组网角色
+#define BODYNET_ROLE_NONE 0 // 单机
+#define BODYNET_ROLE_HUB 1  // 汇聚端: 本机传感器 + 接收其他节点, 做多肢体识别
+#define BODYNET_ROLE_NODE 2 // 肢体节点: 只采集并上报
+
+#define BODYNET_ROLE BODYNET_ROLE_NONE
+#define BODYNET_NODE_ID 1      // 肢体节点编号, 不能与汇聚端相同 (汇聚端丢弃 src 为自己的包)
+#define BODYNET_HUB_ID 0       // 汇聚端节点编号
+#define BODYNET_NODE_MASK 0x03 // 汇聚端期望的节点: 左右手腕
+#define BODYNET_CHANNEL 1      // WiFi信道
+
+#if BODYNET_ROLE == BODYNET_ROLE_NODE && BODYNET_NODE_ID == BODYNET_HUB_ID
+#error "BODYNET_NODE_ID 不能与 BODYNET_HUB_ID 相同"
+#endif
+
+// 当前处理样本的时间戳, 检测器和乐句识别按样本时间计时
+static int64_t sample_time_us = 0;
+
+static uint32_t sample_clock_ms(void)
+{
+    return (uint32_t)(sample_time_us / 1000);
+}
 
 // 用于检测数值变化的变量
 static float last_displayed_roll = 999.0f;
@@ -52,6 +93,252 @@ void update_angles_display(const imu_euler_t *euler)
     }
 }
 
+// 乐句: 一串动作触发和弦/riff/采样
+typedef struct
+{
+    simple_action_t seq[PHRASE_MAX_LEN];
+    int len;
+    uint32_t max_gap_ms;
+    uint32_t max_total_ms;
+    const char *name;
+} phrase_config_t;
+
+static const phrase_config_t phrase_configs[] = {
+    {{HAND_UP, HAND_DOWN}, 2, 1500, 3000, "C大三和弦"},
+    {{ACTION_TILT_DOWN, ACTION_TILT_UP, ACTION_TILT_DOWN}, 3, 1000, 2500, "摇摆riff"},
+    {{HAND_UP, PING_SHANGJU, HAND_DOWN}, 3, 1500, 4000, "G大三和弦"},
+    {{ACTION_TILT_DOWN, ACTION_TILT_UP, ACTION_TILT_DOWN, ACTION_TILT_UP}, 4, 1000, 3500, "鼓点采样"},
+};
+
+// 注册乐句并构建自动机
+void init_phrases()
+{
+    phrase_clear();
+    for (int i = 0; i < (int)(sizeof(phrase_configs) / sizeof(phrase_configs[0])); i++)
+    {
+        const phrase_config_t *cfg = &phrase_configs[i];
+        phrase_add(cfg->seq, cfg->len, cfg->max_gap_ms, cfg->max_total_ms, i);
+    }
+    phrase_build();
+}
+
+// 动作确认后送入乐句识别器
+void handle_phrases(simple_action_t action)
+{
+    phrase_match_t matches[4];
+    int count = phrase_feed(action, sample_clock_ms(), matches, 4);
+
+    for (int i = 0; i < count; i++)
+    {
+        printf("🎶 乐句: %s (用时%lums)\n",
+               phrase_configs[matches[i].tag].name,
+               matches[i].end_time - matches[i].start_time);
+
+        // 这里可以触发和弦/riff/采样
+        // play_phrase(matches[i].tag);
+    }
+}
+
+static bodynet_hub_t body_hub;
+static bodynet_node_t body_node;
+static bodynet_pose_t body_poses[2];
+
+// 初始化多节点组网
+void init_bodynet()
+{
+    if (BODYNET_ROLE == BODYNET_ROLE_NONE)
+    {
+        return;
+    }
+
+    bodynet_espnow_init(BODYNET_CHANNEL);
+    bodynet_transport_t transport = bodynet_espnow_transport();
+
+    if (BODYNET_ROLE == BODYNET_ROLE_HUB)
+    {
+        bodynet_hub_init(&body_hub, BODYNET_HUB_ID, BODYNET_NODE_MASK, 50000, &transport);
+
+        // 多肢体模板: 节点0/1 为左右手腕
+        body_poses[0].limb_mask = 0x03;
+        body_poses[0].limb[0] = quat_point_from_roll_pitch(40.0f, -80.0f, 30.0f);
+        body_poses[0].limb[1] = quat_point_from_roll_pitch(40.0f, -80.0f, 30.0f);
+        body_poses[0].name = "双手举起";
+
+        body_poses[1].limb_mask = 0x03;
+        body_poses[1].limb[0] = quat_point_from_roll_pitch(0.0f, 0.0f, 25.0f);
+        body_poses[1].limb[1] = quat_point_from_roll_pitch(0.0f, 0.0f, 25.0f);
+        body_poses[1].name = "双手放平";
+    }
+    else
+    {
+        bodynet_node_init(&body_node, BODYNET_NODE_ID, BODYNET_HUB_ID, &transport);
+    }
+}
+
+// 多节点组网: 按IMU采样率送入每个样本, 返回 false 表示本机不做单机识别
+bool feed_bodynet(const imu_sample_t *sample)
+{
+    if (BODYNET_ROLE == BODYNET_ROLE_NODE)
+    {
+        bodynet_node_push_sample(&body_node, sample->t_us, &sample->data);
+        return false;
+    }
+    if (BODYNET_ROLE == BODYNET_ROLE_HUB)
+    {
+        bodynet_hub_push_local(&body_hub, sample->t_us, &sample->data);
+    }
+    return true;
+}
+
+// 多节点收发、对时和多肢体识别, 每次主循环调用一次
+void handle_bodynet()
+{
+    int64_t now_us = esp_timer_get_time();
+
+    if (BODYNET_ROLE == BODYNET_ROLE_NODE)
+    {
+        static uint32_t reported_failures = 0;
+        bodynet_node_poll(&body_node, now_us);
+        if (body_node.send_failures - reported_failures >= 100)
+        {
+            printf("⚠️ 多节点发送失败: 累计%lu\n", (unsigned long)body_node.send_failures);
+            reported_failures = body_node.send_failures;
+        }
+        return;
+    }
+
+    if (BODYNET_ROLE == BODYNET_ROLE_HUB)
+    {
+        static int last_pose = -1;
+        bodynet_frame_t frame;
+
+        bodynet_hub_poll(&body_hub, now_us);
+
+        while (bodynet_hub_pop_frame(&body_hub, now_us, &frame))
+        {
+            int pose = -1;
+            for (int i = 0; i < (int)(sizeof(body_poses) / sizeof(body_poses[0])); i++)
+            {
+                if (bodynet_pose_matches(&frame, &body_poses[i]))
+                {
+                    pose = i;
+                    break;
+                }
+            }
+
+            if (pose >= 0 && pose != last_pose)
+            {
+                printf("🕺 多肢体姿态: %s\n", body_poses[pose].name);
+            }
+            last_pose = pose;
+
+            if (body_hub.stats.frames_out % 200 == 0)
+            {
+                bodynet_hub_print_stats(&body_hub);
+            }
+        }
+    }
+}
+
+// 抖动/颤音: 加速度 4~8Hz 频带能量驱动颤音速率和深度
+#define VIBRATO_BAND 2                // spectral_band_edges_hz 中的 [4,8) Hz
+#define VIBRATO_ENERGY_THRESHOLD 0.002f // 低于此能量视为未抖动 (g²)
+#define VIBRATO_FULL_DEPTH_ENERGY 0.05f // 达到此能量时深度为1
+
+void handle_vibrato()
+{
+    static uint32_t last_hop = 0;
+    static bool vibrato_on = false;
+    spectral_features_t features;
+
+    if (!imu_get_spectral(&features) || features.hop_index == last_hop)
+    {
+        return;
+    }
+    last_hop = features.hop_index;
+
+    float energy = features.accel.band_energy[VIBRATO_BAND];
+    bool shaking = energy > VIBRATO_ENERGY_THRESHOLD;
+
+    if (shaking)
+    {
+        float rate = features.accel.band_peak_hz[VIBRATO_BAND]; // 全局主频可能是低频的身体晃动
+        float depth = fminf(1.0f, energy / VIBRATO_FULL_DEPTH_ENERGY);
+
+        if (!vibrato_on || features.hop_index % 8 == 0)
+        {
+            printf("〰️ 颤音: 速率%.1fHz 深度%.2f\n", rate, depth);
+        }
+        // set_vibrato(rate, depth);
+    }
+    else if (vibrato_on)
+    {
+        printf("〰️ 颤音结束\n");
+        // set_vibrato(0, 0);
+    }
+    vibrato_on = shaking;
+
+    if (features.hop_index % 100 == 0)
+    {
+        spectral_print_stats();
+    }
+}
+
+// 音符频率 (按 simple_action_t 顺序, 每个动作一个音符)
+static const float action_frequencies[ACTION_NONE] = {
+    523.25f, // Do高 - 向上倾斜
+    329.63f, // Mi - 向下倾斜
+    261.63f, // Do - 举手放下
+    392.00f, // Sol - 举手
+    440.00f  // La - 平上举
+};
+
+// 使用带预测的三点检测, 每个样本调用一次
+void handle_detection(const imu_euler_t *euler)
+{
+    simple_action_t action;
+    uint32_t execution_time;
+    note_duration_t note_type;
+    note_event_t event = detect_three_point_predictive(euler, &action, &execution_time, &note_type);
+
+    // 处理检测结果
+    switch (event)
+    {
+    case NOTE_EVENT_ONSET:
+    case NOTE_EVENT_TRIGGER:
+        printf("🎵 播放音符: %s -> %.1fHz (%dms)\n",
+               get_action_name(action),
+               action_frequencies[action],
+               note_type);
+
+        // 这里可以添加你的音频播放函数
+        // play_tone(action_frequencies[action], note_type);
+
+        if (event == NOTE_EVENT_TRIGGER)
+        {
+            handle_phrases(action);
+        }
+        break;
+
+    case NOTE_EVENT_CONFIRM:
+        // 提前起音的音符继续播放, 按实际时长修正
+        // update_tone_duration(note_type);
+        handle_phrases(action);
+        print_prediction_stats();
+        break;
+
+    case NOTE_EVENT_CANCEL:
+        // 动作未完成, 快速释放已起音的音符
+        printf("🔇 快速释放: %s\n", get_action_name(action));
+        // release_tone_fast();
+        print_prediction_stats();
+        break;
+
+    default:
+        break;
+    }
+}
+
 extern "C" void app_main(void)
 {
     // 初始化M5设备
@@ -61,54 +348,113 @@ extern "C" void app_main(void)
     // 初始化屏幕显示
     init_display();
 
-    // 启动IMU任务
-    xTaskCreate(imu_task, "imu_task", 4096, NULL, 5, &imu_handle);
+#ifdef FILTERBANK_BENCHMARK
+    // 滤波器组块处理与逐样本处理的耗时对比, 主机上见 host_test/bench_filterbank
+    filterbank_benchmark(100, 32, false);
+    filterbank_benchmark(100, 32, true);
+#endif
 
-    // 主循环变量
-    imu_data_t data;
+    // 启动IMU任务 (静态栈和TCB)
+    // 每批样本写入环形缓冲后 imu_task 用任务通知唤醒主循环
+    imu_handle = xTaskCreateStatic(imu_task, "imu_task", IMU_TASK_STACK_SIZE, xTaskGetCurrentTaskHandle(), 5,
+                                   imu_task_stack, &imu_task_buf);
+
+    // 主循环变量: 每批取出 imu_task 新写入的全部样本 (400Hz), 逐个送入姿态计算和检测
+    static imu_sample_t samples[IMU_RING_LEN];
+    uint32_t sample_cursor = 0;
     imu_euler_t euler;
-    uint32_t execution_time;
-    note_duration_t note_type;
 
-    // 音符频率 (两个动作对应两个音符)
-    const float action_frequencies[] = {
-        523.25f, // Do高 - 向上倾斜
-        329.63f  // Mi - 向下倾斜
-    };
+    three_point_set_clock(sample_clock_ms);
+
+    // 乐句识别
+    init_phrases();
+
+    // 多节点组网
+    init_bodynet();
+
+    // 内存登记: 所有缓冲和检测器上下文都是静态分配的
+    memstat_register_task(xTaskGetCurrentTaskHandle(), "app_main", CONFIG_ESP_MAIN_TASK_STACK_SIZE);
+    memstat_register_task(imu_handle, "imu_task", IMU_TASK_STACK_SIZE);
+    memstat_register_pool("imu任务TCB", sizeof(imu_task_buf));
+    memstat_register_pool("主循环样本缓冲", sizeof(samples));
+    memstat_register_pool("乐句自动机", phrase_static_bytes());
+    memstat_register_pool("滑动DFT", spectral_static_bytes());
+    if (BODYNET_ROLE == BODYNET_ROLE_HUB)
+    {
+        memstat_register_pool("组网汇聚端", sizeof(body_hub));
+    }
+    else if (BODYNET_ROLE == BODYNET_ROLE_NODE)
+    {
+        memstat_register_pool("组网节点", sizeof(body_node));
+    }
+    imu_register_memory();
 
     printf("🎼 三点检测系统启动\n");
     printf("支持动作:\n");
     printf("  向上倾斜: Roll 0° → 25° → 50° (1秒内)\n");
     printf("  向下倾斜: Roll 0° → -25° → -50° (1秒内)\n\n");
 
+    bool steady = false;
+    int64_t next_report_us = MEMSTAT_REPORT_US;
+    int64_t next_display_us = 0;
+
     while (1)
     {
-        M5.update();
+        // 等待 imu_task 写入下一批样本 (约10ms一批)
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(IMU_NOTIFY_TIMEOUT_MS));
+
+        // M5.update() 由 imu_task (I2C总线所有者) 调用, 这里不再访问总线
+        int64_t now_us = esp_timer_get_time();
+        if (!steady && now_us >= STEADY_WARMUP_US)
+        {
+            steady = true;
+            // 初始化等一次性分配都已完成; newlib 首次浮点格式化会分配缓冲, 在进入稳态前做一次
+            printf("预热完成: %.1f秒\n", esp_timer_get_time() / 1e6);
+            memstat_print_budget();
+            memstat_steady_begin();
+        }
+        if (now_us >= next_report_us)
+        {
+            next_report_us += MEMSTAT_REPORT_US;
+            imu_print_bus_stats();
+            memstat_print_watermarks();
+        }
+        // 每次循环检查, 违规在发生后一个循环内中止 (MEMSTAT_STEADY_FATAL)
+        memstat_steady_check();
 
-        if (imu_get_data(&data))
+        int n = imu_read_samples(&sample_cursor, samples, IMU_RING_LEN);
+        bool recognize = true;
+        for (int i = 0; i < n; i++)
         {
+            sample_time_us = samples[i].t_us;
+
             // 计算欧拉角
-            imu_calc_euler_smart(&data, &euler);
+            imu_calc_euler_smart(&samples[i].data, &euler);
 
-            // 更新屏幕角度显示
-            update_angles_display(&euler);
+            // 多节点组网, 肢体节点只上报不识别
+            recognize = feed_bodynet(&samples[i]);
+            if (recognize)
+            {
+                handle_detection(&euler);
+            }
+        }
 
-            // 使用三点检测
-            simple_action_t action = detect_three_point_action(&euler, &execution_time, &note_type);
+        handle_bodynet();
 
-            // 处理检测结果
-            if (action != ACTION_NONE)
+        if (n > 0)
+        {
+            // 更新屏幕角度显示
+            if (now_us >= next_display_us)
             {
-                printf("🎵 播放音符: %s -> %.1fHz (%dms)\n",
-                       get_action_name(action),
-                       action_frequencies[action],
-                       note_type);
+                next_display_us = now_us + DISPLAY_PERIOD_US;
+                update_angles_display(&euler);
+            }
 
-                // 这里可以添加你的音频播放函数
-                // play_tone(action_frequencies[action], note_type);
+            // 抖动/颤音
+            if (recognize)
+            {
+                handle_vibrato();
             }
         }
-
-        vTaskDelay(pdMS_TO_TICKS(50)); // 20Hz刷新率
     }
 }
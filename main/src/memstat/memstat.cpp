@@ -0,0 +1,222 @@
+#include "memstat.h"
+#include "esp_heap_caps.h"
+#include "esp_attr.h"
+#include "sdkconfig.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifndef CONFIG_HEAP_USE_HOOKS
+#warning "未开启 CONFIG_HEAP_USE_HOOKS, 稳态零分配检查只能比较堆剩余, 违规不会中止"
+#endif
+
+// 静态内存池
+typedef struct
+{
+    const char *name;
+    size_t bytes;
+} memstat_pool_t;
+
+// 任务及其稳态分配计数
+typedef struct
+{
+    TaskHandle_t task;
+    const char *name;
+    uint32_t stack_bytes;
+    volatile uint32_t allocs; // 稳态以来的分配次数 (需 CONFIG_HEAP_USE_HOOKS)
+    volatile uint32_t alloc_bytes;
+} memstat_task_t;
+
+static memstat_pool_t pools[MEMSTAT_MAX_POOLS];
+static int pool_count = 0;
+static memstat_task_t tasks[MEMSTAT_MAX_TASKS];
+static volatile int task_count = 0;
+
+static portMUX_TYPE register_lock = portMUX_INITIALIZER_UNLOCKED; // 登记可能来自不同任务
+
+static volatile bool steady = false;
+static size_t steady_free_bytes = 0; // 进入稳态时的堆剩余
+static uint32_t reported_allocs = 0; // 已报告过的违规次数, 只打印新增的
+
+// ============= 登记 =============
+
+void memstat_register_pool(const char *name, size_t bytes)
+{
+    portENTER_CRITICAL(&register_lock);
+    bool full = pool_count >= MEMSTAT_MAX_POOLS;
+    if (!full)
+    {
+        pools[pool_count].name = name;
+        pools[pool_count].bytes = bytes;
+        pool_count++;
+    }
+    portEXIT_CRITICAL(&register_lock);
+
+    if (full)
+    {
+        printf("内存池登记已满: %s\r\n", name);
+    }
+}
+
+void memstat_register_task(TaskHandle_t task, const char *name, uint32_t stack_bytes)
+{
+    bool ok = false;
+    portENTER_CRITICAL(&register_lock);
+    if (task != NULL && task_count < MEMSTAT_MAX_TASKS)
+    {
+        memstat_task_t *t = &tasks[task_count];
+        t->task = task;
+        t->name = name;
+        t->stack_bytes = stack_bytes;
+        t->allocs = 0;
+        t->alloc_bytes = 0;
+        task_count++; // 最后增加, 分配钩子只看已填好的项
+        ok = true;
+    }
+    portEXIT_CRITICAL(&register_lock);
+
+    if (!ok)
+    {
+        printf("任务登记失败: %s\r\n", name);
+    }
+}
+
+// ============= 分配钩子 =============
+
+#ifdef CONFIG_HEAP_USE_HOOKS
+// 每次堆分配都会调用, 可能在中断中, 只做查表计数
+extern "C" IRAM_ATTR void esp_heap_trace_alloc_hook(void *ptr, size_t size, uint32_t caps)
+{
+    if (!steady || xPortInIsrContext())
+    {
+        return;
+    }
+
+    TaskHandle_t current = xTaskGetCurrentTaskHandle();
+    for (int i = 0; i < task_count; i++)
+    {
+        if (tasks[i].task == current)
+        {
+            tasks[i].allocs++;
+            tasks[i].alloc_bytes += size;
+            return;
+        }
+    }
+}
+
+extern "C" IRAM_ATTR void esp_heap_trace_free_hook(void *ptr)
+{
+}
+#endif
+
+// ============= 报告 =============
+
+static void print_heap(void)
+{
+    printf("堆: 剩余%u 历史最低%u 最大连续块%u\r\n",
+           (unsigned)heap_caps_get_free_size(MALLOC_CAP_8BIT),
+           (unsigned)heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT),
+           (unsigned)heap_caps_get_largest_free_block(MALLOC_CAP_8BIT));
+}
+
+void memstat_print_budget(void)
+{
+    size_t pool_total = 0;
+    uint32_t stack_total = 0;
+
+    printf("===== 内存预算 =====\r\n");
+    for (int i = 0; i < pool_count; i++)
+    {
+        printf("  %s: %u\r\n", pools[i].name, (unsigned)pools[i].bytes);
+        pool_total += pools[i].bytes;
+    }
+    printf("静态内存池合计: %u\r\n", (unsigned)pool_total);
+
+    for (int i = 0; i < task_count; i++)
+    {
+        printf("  %s 栈: %lu\r\n", tasks[i].name, (unsigned long)tasks[i].stack_bytes);
+        stack_total += tasks[i].stack_bytes;
+    }
+    printf("任务栈合计: %lu\r\n", (unsigned long)stack_total);
+
+    print_heap();
+#ifndef CONFIG_HEAP_USE_HOOKS
+    printf("未开启 CONFIG_HEAP_USE_HOOKS, 稳态分配检查只比较堆剩余\r\n");
+#endif
+}
+
+void memstat_print_watermarks(void)
+{
+    for (int i = 0; i < task_count; i++)
+    {
+        // ESP-IDF 的栈深度以字节计
+        uint32_t free_bytes = uxTaskGetStackHighWaterMark(tasks[i].task);
+        uint32_t used = tasks[i].stack_bytes - free_bytes;
+        printf("栈 %s: 最多使用%lu/%lu (%lu%%)\r\n", tasks[i].name,
+               (unsigned long)used, (unsigned long)tasks[i].stack_bytes,
+               (unsigned long)(used * 100 / tasks[i].stack_bytes));
+    }
+    if (steady && reported_allocs > 0)
+    {
+        printf("稳态堆分配累计%lu次\r\n", (unsigned long)reported_allocs);
+    }
+    print_heap();
+}
+
+// ============= 稳态分配检查 =============
+
+void memstat_steady_begin(void)
+{
+    for (int i = 0; i < task_count; i++)
+    {
+        tasks[i].allocs = 0;
+        tasks[i].alloc_bytes = 0;
+    }
+    reported_allocs = 0;
+    steady_free_bytes = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    steady = true;
+    printf("进入稳态, 此后登记任务不应再分配堆内存\r\n");
+}
+
+uint32_t memstat_steady_check(void)
+{
+    if (!steady)
+    {
+        return 0;
+    }
+
+#ifdef CONFIG_HEAP_USE_HOOKS
+    uint32_t total = 0;
+    for (int i = 0; i < task_count; i++)
+    {
+        total += tasks[i].allocs;
+    }
+    if (total > reported_allocs)
+    {
+        for (int i = 0; i < task_count; i++)
+        {
+            if (tasks[i].allocs > 0)
+            {
+                printf("⚠️ 稳态堆分配: %s %lu次 %lu字节\r\n", tasks[i].name,
+                       (unsigned long)tasks[i].allocs, (unsigned long)tasks[i].alloc_bytes);
+            }
+        }
+        reported_allocs = total;
+#if MEMSTAT_STEADY_FATAL
+        printf("稳态零分配检查失败, 中止\r\n");
+        fflush(stdout);
+        abort();
+#endif
+    }
+    return total;
+#else
+    // 没有钩子时无法区分任务 (WiFi等未登记任务也会分配), 堆剩余减少只作为提示, 不中止
+    size_t free_bytes = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    if (free_bytes < steady_free_bytes)
+    {
+        printf("⚠️ 稳态以来堆剩余减少%u字节\r\n", (unsigned)(steady_free_bytes - free_bytes));
+        steady_free_bytes = free_bytes;
+        return 1;
+    }
+    return 0;
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+#ifndef MEMSTAT_H
+#define MEMSTAT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define MEMSTAT_MAX_POOLS 16 // 最多登记的静态内存池
+#define MEMSTAT_MAX_TASKS 8  // 最多登记的任务
+
+// 稳态分配违规时中止运行 (需 CONFIG_HEAP_USE_HOOKS, 见 sdkconfig.defaults).
+// 演出固件默认只打印并计数; 调试构建可定义为1, 让违规立即暴露
+#ifndef MEMSTAT_STEADY_FATAL
+#define MEMSTAT_STEADY_FATAL 0
+#endif
+
+    /**
+     * @brief 登记一块静态分配的内存 (环形缓冲、检测器上下文、事件队列等), 用于启动时预算报告
+     */
+    void memstat_register_pool(const char *name, size_t bytes);
+
+    /**
+     * @brief 登记任务及其栈预算 (字节), 用于栈高水位跟踪和稳态分配检查
+     */
+    void memstat_register_task(TaskHandle_t task, const char *name, uint32_t stack_bytes);
+
+    /**
+     * @brief 启动时内存预算报告: 静态内存池、任务栈预算、堆剩余
+     */
+    void memstat_print_budget(void);
+
+    /**
+     * @brief 各任务栈高水位和堆历史最低剩余
+     */
+    void memstat_print_watermarks(void);
+
+    /**
+     * @brief 进入稳态: 此后登记任务中的任何堆分配都视为违规
+     * @note 需要开启 CONFIG_HEAP_USE_HOOKS 才能逐次统计; 未开启时只比较堆剩余量
+     */
+    void memstat_steady_begin(void);
+
+    /**
+     * @brief 检查稳态以来的分配, 有新增违规时打印; MEMSTAT_STEADY_FATAL 为1且开启钩子时随后 abort()
+     * @return 稳态以来登记任务中的分配次数
+     */
+    uint32_t memstat_steady_check(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MEMSTAT_H
\ No newline at end of file
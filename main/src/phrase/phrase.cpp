@@ -0,0 +1,248 @@
+#include "phrase.h"
+#include <stdio.h>
+#include <string.h>
+
+#define NODE_NONE 0xFFFF
+#define PHRASE_NONE -1
+
+// 乐句定义
+typedef struct
+{
+    uint8_t len;
+    uint32_t max_gap_ms;
+    uint32_t max_total_ms;
+    uint32_t tag;
+    int16_t next_same; // 在同一状态结束的下一个乐句
+} phrase_def_t;
+
+// Aho-Corasick 自动机, 全部静态分配
+typedef struct
+{
+    uint16_t next[PHRASE_MAX_NODES][PHRASE_ALPHABET]; // 完整转移表 (build 后无 NODE_NONE)
+    uint16_t fail[PHRASE_MAX_NODES];                  // 失败链接
+    uint16_t dict[PHRASE_MAX_NODES];                  // 沿失败链接最近的有输出的状态
+    int16_t out[PHRASE_MAX_NODES];                    // 在此状态结束的第一个乐句
+    uint16_t node_count;
+
+    phrase_def_t phrases[PHRASE_MAX_PHRASES];
+    uint16_t phrase_count;
+    bool built;
+
+    // 动作流状态
+    uint16_t state;
+    uint32_t times[PHRASE_MAX_LEN]; // 最近动作时间的环形缓冲
+    uint8_t time_head;
+    uint8_t time_count;
+} phrase_automaton_t;
+
+static phrase_automaton_t ac;
+
+// 构建用BFS队列
+static uint16_t bfs_queue[PHRASE_MAX_NODES];
+
+static uint16_t new_node(void)
+{
+    uint16_t n = ac.node_count++;
+    memset(ac.next[n], 0xFF, sizeof(ac.next[n]));
+    ac.fail[n] = 0;
+    ac.dict[n] = NODE_NONE;
+    ac.out[n] = PHRASE_NONE;
+    return n;
+}
+
+void phrase_clear(void)
+{
+    ac.node_count = 0;
+    ac.phrase_count = 0;
+    ac.built = false;
+    new_node(); // 根状态
+    phrase_reset_stream();
+}
+
+int phrase_add(const simple_action_t *seq, int len, uint32_t max_gap_ms, uint32_t max_total_ms, uint32_t tag)
+{
+    if (ac.node_count == 0)
+    {
+        phrase_clear();
+    }
+    if (seq == NULL || len <= 0 || len > PHRASE_MAX_LEN || ac.phrase_count >= PHRASE_MAX_PHRASES || ac.built)
+    {
+        printf("添加乐句失败\n");
+        return -1;
+    }
+
+    // 插入字典树
+    uint16_t node = 0;
+    for (int i = 0; i < len; i++)
+    {
+        int a = (int)seq[i];
+        if (a < 0 || a >= PHRASE_ALPHABET)
+        {
+            printf("添加乐句失败: 无效动作 %d\n", a);
+            return -1;
+        }
+        if (ac.next[node][a] == NODE_NONE)
+        {
+            ac.next[node][a] = new_node();
+        }
+        node = ac.next[node][a];
+    }
+
+    int id = ac.phrase_count++;
+    phrase_def_t *p = &ac.phrases[id];
+    p->len = (uint8_t)len;
+    p->max_gap_ms = max_gap_ms;
+    p->max_total_ms = max_total_ms;
+    p->tag = tag;
+    p->next_same = ac.out[node];
+    ac.out[node] = (int16_t)id;
+
+    return id;
+}
+
+bool phrase_build(void)
+{
+    if (ac.node_count == 0)
+    {
+        phrase_clear();
+    }
+
+    // 构建后缺失转移已补全, 字典树的边无法与补出的边区分, 不能再次构建
+    if (ac.built)
+    {
+        printf("乐句自动机已构建, 需 phrase_clear 后重新添加\n");
+        return false;
+    }
+
+    int head = 0;
+    int tail = 0;
+
+    // 根的缺失转移指回根
+    for (int a = 0; a < PHRASE_ALPHABET; a++)
+    {
+        uint16_t child = ac.next[0][a];
+        if (child == NODE_NONE)
+        {
+            ac.next[0][a] = 0;
+        }
+        else
+        {
+            ac.fail[child] = 0;
+            bfs_queue[tail++] = child;
+        }
+    }
+
+    // BFS 计算失败链接, 同时把缺失转移补成完整DFA
+    while (head < tail)
+    {
+        uint16_t node = bfs_queue[head++];
+        uint16_t f = ac.fail[node];
+
+        ac.dict[node] = ac.out[f] != PHRASE_NONE ? f : ac.dict[f];
+
+        for (int a = 0; a < PHRASE_ALPHABET; a++)
+        {
+            uint16_t child = ac.next[node][a];
+            if (child == NODE_NONE)
+            {
+                ac.next[node][a] = ac.next[f][a];
+            }
+            else
+            {
+                ac.fail[child] = ac.next[f][a];
+                bfs_queue[tail++] = child;
+            }
+        }
+    }
+
+    ac.built = true;
+    phrase_reset_stream();
+
+    printf("乐句自动机: %d个乐句, %d个状态\n", ac.phrase_count, ac.node_count);
+    return true;
+}
+
+void phrase_reset_stream(void)
+{
+    ac.state = 0;
+    ac.time_head = 0;
+    ac.time_count = 0;
+}
+
+size_t phrase_static_bytes(void)
+{
+    return sizeof(ac) + sizeof(bfs_queue);
+}
+
+// 检查乐句时间窗: 最近 len 个动作的间隔和总时长
+static bool check_timing(const phrase_def_t *p, uint32_t *start_time)
+{
+    if (p->len > ac.time_count)
+    {
+        return false;
+    }
+
+    // time_head 指向最新动作之后的位置
+    int idx = (ac.time_head + PHRASE_MAX_LEN - 1) % PHRASE_MAX_LEN;
+    uint32_t last = ac.times[idx];
+    uint32_t end = last;
+
+    for (int i = 1; i < p->len; i++)
+    {
+        idx = (idx + PHRASE_MAX_LEN - 1) % PHRASE_MAX_LEN;
+        uint32_t t = ac.times[idx];
+        if (last - t > p->max_gap_ms)
+        {
+            return false;
+        }
+        last = t;
+    }
+
+    if (end - last > p->max_total_ms)
+    {
+        return false;
+    }
+
+    *start_time = last;
+    return true;
+}
+
+int phrase_feed(simple_action_t action, uint32_t time_ms, phrase_match_t *matches, int max_matches)
+{
+    int a = (int)action;
+    if (!ac.built || a < 0 || a >= PHRASE_ALPHABET)
+    {
+        return 0;
+    }
+
+    ac.state = ac.next[ac.state][a];
+
+    ac.times[ac.time_head] = time_ms;
+    ac.time_head = (ac.time_head + 1) % PHRASE_MAX_LEN;
+    if (ac.time_count < PHRASE_MAX_LEN)
+    {
+        ac.time_count++;
+    }
+
+    // 当前状态及其字典后缀链接上的所有乐句
+    int count = 0;
+    uint16_t node = ac.out[ac.state] != PHRASE_NONE ? ac.state : ac.dict[ac.state];
+    while (node != NODE_NONE && count < max_matches)
+    {
+        for (int16_t id = ac.out[node]; id != PHRASE_NONE && count < max_matches; id = ac.phrases[id].next_same)
+        {
+            uint32_t start_time;
+            if (check_timing(&ac.phrases[id], &start_time))
+            {
+                matches[count].phrase_id = (uint16_t)id;
+                matches[count].tag = ac.phrases[id].tag;
+                matches[count].start_time = start_time;
+                matches[count].end_time = time_ms;
+                count++;
+            }
+        }
+        node = ac.dict[node];
+    }
+
+    return count;
+}
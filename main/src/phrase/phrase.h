@@ -0,0 +1,74 @@
+#ifndef PHRASE_H
+#define PHRASE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "imu/imu.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define PHRASE_MAX_PHRASES 256                                 // 最多乐句数
+#define PHRASE_MAX_LEN 8                                       // 单个乐句最多动作数
+#define PHRASE_ALPHABET ((int)ACTION_NONE)                     // 动作种类数
+#define PHRASE_MAX_NODES (PHRASE_MAX_PHRASES * PHRASE_MAX_LEN + 1) // 自动机最大状态数
+
+    // 乐句匹配结果
+    typedef struct
+    {
+        uint16_t phrase_id;  // phrase_add 返回的编号
+        uint32_t tag;        // 用户数据(和弦/riff/采样编号)
+        uint32_t start_time; // 乐句第一个动作时间(ms)
+        uint32_t end_time;   // 乐句最后一个动作时间(ms)
+    } phrase_match_t;
+
+    /**
+     * @brief 清空所有乐句和自动机
+     */
+    void phrase_clear(void);
+
+    /**
+     * @brief 添加乐句, 需在 phrase_build 之前调用
+     * @param seq 动作序列
+     * @param len 序列长度 (1 ~ PHRASE_MAX_LEN)
+     * @param max_gap_ms 相邻两个动作的最大间隔
+     * @param max_total_ms 整个乐句的最大时长
+     * @param tag 用户数据, 匹配时原样返回
+     * @return 乐句编号, 失败返回 -1
+     */
+    int phrase_add(const simple_action_t *seq, int len, uint32_t max_gap_ms, uint32_t max_total_ms, uint32_t tag);
+
+    /**
+     * @brief 构建 Aho-Corasick 自动机 (失败链接 + 完整转移表)
+     * @return true 成功; 已构建过返回 false, 自动机保持不变 (需 phrase_clear 后重新添加)
+     */
+    bool phrase_build(void);
+
+    /**
+     * @brief 输入一个动作事件, 每个事件一次查表, 不分配内存
+     * @param action 动作
+     * @param time_ms 动作完成时间
+     * @param matches 输出匹配到的乐句
+     * @param max_matches matches 容量
+     * @return 匹配到的乐句数
+     */
+    int phrase_feed(simple_action_t action, uint32_t time_ms, phrase_match_t *matches, int max_matches);
+
+    /**
+     * @brief 重置动作流状态, 保留已构建的自动机
+     */
+    void phrase_reset_stream(void);
+
+    /**
+     * @brief 自动机静态存储的字节数, 用于内存预算报告
+     */
+    size_t phrase_static_bytes(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PHRASE_H
\ No newline at end of file
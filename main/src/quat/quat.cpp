@@ -0,0 +1,102 @@
+#include "quat.h"
+#include <math.h>
+
+#define DEG_TO_RAD 0.017453293f
+#define RAD_TO_DEG 57.2957795f
+
+// ============= 倾斜四元数 =============
+
+// 与 imu_calc_euler_optimized 保持一致的约定:
+//   roll  = atan2(gy, gz)
+//   pitch = asin(-gx)
+// 重力方向 g 到 +Z 的最短弧旋转: q = normalize(1 + g·z, g × z)
+quat_t quat_from_gravity(float gx, float gy, float gz)
+{
+    quat_t q;
+    float w = 1.0f + gz;
+
+    // 重力完全朝 -Z (倒置)时最短弧不唯一, 取绕X轴180°
+    if (w < 1e-6f)
+    {
+        q.w = 0.0f;
+        q.x = 1.0f;
+        q.y = 0.0f;
+        q.z = 0.0f;
+        return q;
+    }
+
+    float n = sqrtf(w * w + gx * gx + gy * gy);
+    q.w = w / n;
+    q.x = gy / n;
+    q.y = -gx / n;
+    q.z = 0.0f;
+    return q;
+}
+
+void quat_to_gravity(const quat_t *q, float *gx, float *gy, float *gz)
+{
+    // 旋转矩阵第三行, 即 R^T * (0, 0, 1)
+    *gx = 2.0f * (q->x * q->z - q->w * q->y);
+    *gy = 2.0f * (q->y * q->z + q->w * q->x);
+    *gz = 1.0f - 2.0f * (q->x * q->x + q->y * q->y);
+}
+
+quat_t quat_from_roll_pitch(float roll_deg, float pitch_deg)
+{
+    float r = roll_deg * DEG_TO_RAD;
+    float p = pitch_deg * DEG_TO_RAD;
+    float cp = cosf(p);
+
+    return quat_from_gravity(-sinf(p), cp * sinf(r), cp * cosf(r));
+}
+
+void quat_to_roll_pitch(const quat_t *q, float *roll_deg, float *pitch_deg)
+{
+    float gx, gy, gz;
+    quat_to_gravity(q, &gx, &gy, &gz);
+
+    float s = fmaxf(-1.0f, fminf(1.0f, -gx));
+    *pitch_deg = asinf(s) * RAD_TO_DEG;
+
+    // pitch ±90° 时 roll 无定义
+    if (gy * gy + gz * gz < 1e-8f)
+    {
+        *roll_deg = 0.0f;
+    }
+    else
+    {
+        *roll_deg = atan2f(gy, gz) * RAD_TO_DEG;
+    }
+}
+
+quat_point_t quat_point_from_roll_pitch(float roll_deg, float pitch_deg, float tolerance_deg)
+{
+    quat_point_t point;
+    point.q = quat_from_roll_pitch(roll_deg, pitch_deg);
+    point.cos_half_tol = cosf(tolerance_deg * 0.5f * DEG_TO_RAD);
+    return point;
+}
+
+// ============= 测地距离 =============
+
+float quat_abs_dot(const quat_t *a, const quat_t *b)
+{
+    return fabsf(a->w * b->w + a->x * b->x + a->y * b->y + a->z * b->z);
+}
+
+float quat_geodesic_deg(const quat_t *a, const quat_t *b)
+{
+    float d = fminf(1.0f, quat_abs_dot(a, b));
+    return 2.0f * acosf(d) * RAD_TO_DEG;
+}
+
+float quat_approx_angle(const quat_t *a, const quat_t *b)
+{
+    float d = fminf(1.0f, quat_abs_dot(a, b));
+    return 2.0f * sqrtf(2.0f * (1.0f - d));
+}
+
+bool quat_point_matches(const quat_t *q, const quat_point_t *point)
+{
+    return quat_abs_dot(q, &point->q) >= point->cos_half_tol;
+}
@@ -0,0 +1,70 @@
+#ifndef QUAT_H
+#define QUAT_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+    // 单位四元数 (w, x, y, z)
+    typedef struct
+    {
+        float w, x, y, z;
+    } quat_t;
+
+    // 四元数姿态特征点
+    // cos_half_tol 在建表时预先计算, 匹配时只做点积, 不调用三角函数
+    typedef struct
+    {
+        quat_t q;
+        float cos_half_tol; // cos(容差/2)
+    } quat_point_t;
+
+    /**
+     * @brief 由归一化的重力方向(机体坐标系加速度)计算倾斜四元数
+     *        即把重力方向旋转到 +Z 的最短弧旋转, 不含yaw, 在pitch ±90° 处连续
+     * @note 只用sqrt, 不调用三角函数
+     */
+    quat_t quat_from_gravity(float gx, float gy, float gz);
+
+    /**
+     * @brief 倾斜四元数对应的机体坐标系重力方向
+     */
+    void quat_to_gravity(const quat_t *q, float *gx, float *gy, float *gz);
+
+    /**
+     * @brief 旧版 roll/pitch 模板(度) 转换为倾斜四元数
+     */
+    quat_t quat_from_roll_pitch(float roll_deg, float pitch_deg);
+
+    /**
+     * @brief 倾斜四元数转换回旧版 roll/pitch (度)
+     * @note pitch = ±90° 时roll无定义, 此时返回 roll = 0
+     */
+    void quat_to_roll_pitch(const quat_t *q, float *roll_deg, float *pitch_deg);
+
+    /**
+     * @brief 由 roll/pitch/容差(度) 构造特征点
+     */
+    quat_point_t quat_point_from_roll_pitch(float roll_deg, float pitch_deg, float tolerance_deg);
+
+    // 四元数点积的绝对值 (q 与 -q 表示同一姿态)
+    float quat_abs_dot(const quat_t *a, const quat_t *b);
+
+    // 两个姿态之间的测地距离(度), 仅用于调试显示
+    float quat_geodesic_deg(const quat_t *a, const quat_t *b);
+
+    // 近似测地距离(弧度): 2*sqrt(2*(1-|a·b|)), 小角度时与 2*acos 一致, 单调且不调用三角函数
+    float quat_approx_angle(const quat_t *a, const quat_t *b);
+
+    // 测地距离是否在特征点容差内: |a·b| >= cos(容差/2)
+    bool quat_point_matches(const quat_t *q, const quat_point_t *point);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // QUAT_H
\ No newline at end of file
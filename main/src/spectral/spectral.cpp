@@ -0,0 +1,221 @@
+#include "spectral.h"
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#ifdef SPECTRAL_PROFILE
+#include <chrono>
+#endif
+
+// 阻尼系数, 防止递归累积误差导致发散
+#define SDFT_R 0.9999f
+
+const float spectral_band_edges_hz[SPECTRAL_NUM_BANDS + 1] = {0.5f, 2.0f, 4.0f, 8.0f, 1000.0f};
+
+// 滑动DFT状态, 全部静态分配
+typedef struct
+{
+    float re[SPECTRAL_CHANNELS][SPECTRAL_BINS];
+    float im[SPECTRAL_CHANNELS][SPECTRAL_BINS];
+    float history[SPECTRAL_CHANNELS][SPECTRAL_N];
+
+    float tw_re[SPECTRAL_BINS]; // r * cos(2πk/N)
+    float tw_im[SPECTRAL_BINS]; // r * sin(2πk/N)
+    float r_n;                  // r^N
+    uint8_t band_of_bin[SPECTRAL_BINS];
+
+    float sample_rate_hz;
+    int hop;
+    int pos;      // history 写入位置
+    int filled;   // 已填充样本数
+    int hop_count;
+    uint32_t hop_index;
+
+    spectral_stats_t stats;
+} sdft_t;
+
+static sdft_t sdft;
+
+void spectral_init(float sample_rate_hz, int hop)
+{
+    memset(&sdft, 0, sizeof(sdft));
+    sdft.sample_rate_hz = sample_rate_hz;
+    sdft.hop = hop > 0 ? hop : 1;
+    sdft.r_n = powf(SDFT_R, SPECTRAL_N);
+
+    for (int b = 0; b < SPECTRAL_BINS; b++)
+    {
+        int k = b + 1;
+        float w = 2.0f * (float)M_PI * k / SPECTRAL_N;
+        sdft.tw_re[b] = SDFT_R * cosf(w);
+        sdft.tw_im[b] = SDFT_R * sinf(w);
+
+        // 频点所属频带, 低于第一个边界的记为 SPECTRAL_NUM_BANDS (不计入)
+        float hz = k * sample_rate_hz / SPECTRAL_N;
+        sdft.band_of_bin[b] = SPECTRAL_NUM_BANDS;
+        for (int i = 0; i < SPECTRAL_NUM_BANDS; i++)
+        {
+            if (hz >= spectral_band_edges_hz[i] && hz < spectral_band_edges_hz[i + 1])
+            {
+                sdft.band_of_bin[b] = i;
+                break;
+            }
+        }
+    }
+}
+
+// 峰值频点与相邻频点做抛物线插值, 细化后的频率(Hz); 偏移限制在半个频点内
+static float peak_hz(const float *power, int best)
+{
+    float offset = 0.0f;
+    if (best > 0 && best < SPECTRAL_BINS - 1)
+    {
+        float denom = power[best - 1] - 2.0f * power[best] + power[best + 1];
+        if (denom < 0.0f)
+        {
+            offset = 0.5f * (power[best - 1] - power[best + 1]) / denom;
+            offset = fmaxf(-0.5f, fminf(0.5f, offset));
+        }
+    }
+    return (best + 1 + offset) * sdft.sample_rate_hz / SPECTRAL_N;
+}
+
+// 三轴功率谱合并, 求主频、各频带能量和各频带峰值频率
+static void compute_band(int first_channel, spectral_band_t *band)
+{
+    float power[SPECTRAL_BINS];
+    int band_best[SPECTRAL_NUM_BANDS];
+    const float scale = 4.0f / (SPECTRAL_N * SPECTRAL_N); // 单边谱幅值平方
+
+    memset(band, 0, sizeof(*band));
+    for (int i = 0; i < SPECTRAL_NUM_BANDS; i++)
+    {
+        band_best[i] = -1;
+    }
+
+    int best = 0;
+    for (int b = 0; b < SPECTRAL_BINS; b++)
+    {
+        float p = 0.0f;
+        for (int c = first_channel; c < first_channel + 3; c++)
+        {
+            p += sdft.re[c][b] * sdft.re[c][b] + sdft.im[c][b] * sdft.im[c][b];
+        }
+        p *= scale;
+        power[b] = p;
+
+        band->total_energy += p;
+        int i = sdft.band_of_bin[b];
+        if (i < SPECTRAL_NUM_BANDS)
+        {
+            band->band_energy[i] += p;
+            if (band_best[i] < 0 || p > power[band_best[i]])
+            {
+                band_best[i] = b;
+            }
+        }
+        if (p > power[best])
+        {
+            best = b;
+        }
+    }
+
+    band->dominant_hz = peak_hz(power, best);
+    band->dominant_power = power[best];
+    for (int i = 0; i < SPECTRAL_NUM_BANDS; i++)
+    {
+        band->band_peak_hz[i] = band_best[i] >= 0 ? peak_hz(power, band_best[i]) : 0.0f;
+    }
+}
+
+bool spectral_push(const imu_data_t *data, spectral_features_t *out)
+{
+#ifdef SPECTRAL_PROFILE
+    auto begin = std::chrono::steady_clock::now();
+#endif
+
+    const float x_new[SPECTRAL_CHANNELS] = {data->accel_x, data->accel_y, data->accel_z,
+                                            data->gyro_x, data->gyro_y, data->gyro_z};
+
+    // X_k = r·e^{j2πk/N} · (X_k + x_new - r^N·x_old)
+    for (int c = 0; c < SPECTRAL_CHANNELS; c++)
+    {
+        float delta = x_new[c] - sdft.r_n * sdft.history[c][sdft.pos];
+        sdft.history[c][sdft.pos] = x_new[c];
+
+        float *re = sdft.re[c];
+        float *im = sdft.im[c];
+        for (int b = 0; b < SPECTRAL_BINS; b++)
+        {
+            float a = re[b] + delta;
+            float bi = im[b];
+            re[b] = a * sdft.tw_re[b] - bi * sdft.tw_im[b];
+            im[b] = a * sdft.tw_im[b] + bi * sdft.tw_re[b];
+        }
+    }
+    sdft.pos = (sdft.pos + 1) % SPECTRAL_N;
+
+#ifdef SPECTRAL_PROFILE
+    auto updated = std::chrono::steady_clock::now();
+    float update_us = std::chrono::duration<float, std::micro>(updated - begin).count();
+    sdft.stats.samples++;
+    sdft.stats.update_sum_us += update_us;
+    if (update_us > sdft.stats.update_max_us)
+    {
+        sdft.stats.update_max_us = update_us;
+    }
+#endif
+
+    // 窗口填满前不输出
+    if (sdft.filled < SPECTRAL_N)
+    {
+        sdft.filled++;
+        return false;
+    }
+    if (++sdft.hop_count < sdft.hop)
+    {
+        return false;
+    }
+    sdft.hop_count = 0;
+
+    out->hop_index = ++sdft.hop_index;
+    compute_band(0, &out->accel);
+    compute_band(3, &out->gyro);
+
+#ifdef SPECTRAL_PROFILE
+    float hop_us = std::chrono::duration<float, std::micro>(std::chrono::steady_clock::now() - updated).count();
+    sdft.stats.hops++;
+    sdft.stats.hop_sum_us += hop_us;
+    if (hop_us > sdft.stats.hop_max_us)
+    {
+        sdft.stats.hop_max_us = hop_us;
+    }
+#endif
+
+    return true;
+}
+
+void spectral_get_stats(spectral_stats_t *stats)
+{
+    *stats = sdft.stats;
+}
+
+void spectral_print_stats(void)
+{
+    const spectral_stats_t *stats = &sdft.stats;
+    if (stats->samples == 0)
+    {
+        return;
+    }
+
+    printf("频谱耗时: 更新 平均%.2fus 最大%.2fus", stats->update_sum_us / stats->samples, stats->update_max_us);
+    if (stats->hops > 0)
+    {
+        printf(", hop 平均%.2fus 最大%.2fus", stats->hop_sum_us / stats->hops, stats->hop_max_us);
+    }
+    printf("\n");
+}
+
+size_t spectral_static_bytes(void)
+{
+    return sizeof(sdft);
+}
@@ -0,0 +1,77 @@
+#ifndef SPECTRAL_H
+#define SPECTRAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "imu/imu.h"
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+#define SPECTRAL_N 64                 // 滑动窗口长度
+#define SPECTRAL_BINS (SPECTRAL_N / 2) // 计算的频点 1 ~ N/2 (去掉直流/重力)
+#define SPECTRAL_CHANNELS 6           // accel xyz + gyro xyz
+#define SPECTRAL_NUM_BANDS 4          // 频带数
+
+    // 单个传感器(三轴合并)的频谱特征
+    typedef struct
+    {
+        float dominant_hz;                          // 主频
+        float dominant_power;                       // 主频功率
+        float band_energy[SPECTRAL_NUM_BANDS];      // 各频带能量
+        float band_peak_hz[SPECTRAL_NUM_BANDS];     // 各频带内的峰值频率, 主频可能落在别的频带 (如0.78Hz的身体晃动)
+        float total_energy;                         // 全部频点能量
+    } spectral_band_t;
+
+    // 每个hop输出一次
+    typedef struct spectral_features
+    {
+        uint32_t hop_index;
+        spectral_band_t accel;
+        spectral_band_t gyro;
+    } spectral_features_t;
+
+    // CPU耗时统计 (微秒), 只在定义 SPECTRAL_PROFILE 时采集, 否则计时本身会计入每个样本的开销
+    // 不开启时用主机基准测试 host_test/bench_spectral 测量
+    typedef struct
+    {
+        uint32_t samples;
+        uint32_t hops;
+        float update_max_us; // 单样本滑动DFT更新最大耗时
+        float hop_max_us;    // 单次hop特征计算最大耗时
+        double update_sum_us;
+        double hop_sum_us;
+    } spectral_stats_t;
+
+    // 频带边界 (Hz): [0.5,2) [2,4) [4,8) [8,Nyquist]
+    extern const float spectral_band_edges_hz[SPECTRAL_NUM_BANDS + 1];
+
+    /**
+     * @brief 初始化滑动DFT, 旋转因子在此预先计算
+     * @param sample_rate_hz 采样率
+     * @param hop 每隔多少个样本输出一次特征
+     */
+    void spectral_init(float sample_rate_hz, int hop);
+
+    /**
+     * @brief 输入一个样本, 每样本 O(通道数 × 频点数)
+     * @return true 本次产生了新特征, 写入 out
+     */
+    bool spectral_push(const imu_data_t *data, spectral_features_t *out);
+
+    void spectral_get_stats(spectral_stats_t *stats);
+    void spectral_print_stats(void);
+
+    /**
+     * @brief 滑动DFT静态存储的字节数, 用于内存预算报告
+     */
+    size_t spectral_static_bytes(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SPECTRAL_H
\ No newline at end of file